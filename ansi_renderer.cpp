@@ -0,0 +1,295 @@
+// ansi_renderer.cpp - ANSI 렌더러 구현
+
+#include "ansi_renderer.h"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <unistd.h>
+
+// SGR colors matching snake_game's color pairs. Each one resets first, so it comes out
+// right whatever attributes were in effect.
+#define SGR_RESET  "\x1b[0m"
+#define SGR_GREEN  "\x1b[0;32m" // Pair 1: snake body
+#define SGR_RED    "\x1b[0;31m" // Pair 2: poison
+#define SGR_YELLOW "\x1b[0;33m" // Pair 3: head, growth item
+#define SGR_BLUE   "\x1b[0;34m" // Pair 4: gate
+#define SGR_WHITE  "\x1b[0;37m" // Pair 5: wall
+#define SGR_CYAN   "\x1b[0;36m" // Pair 6: immune wall
+
+// Byte strings with their lengths worked out at compile time
+struct Encoded {
+    const char *bytes;
+    int         length;
+};
+#define ENCODED(text) {text, (int)sizeof(text) - 1}
+
+enum Ink {
+    INK_DEFAULT = 0,
+    INK_GREEN,
+    INK_RED,
+    INK_YELLOW,
+    INK_BLUE,
+    INK_WHITE,
+    INK_CYAN,
+    INK_ANY, // Glyphs that look the same in any colour
+};
+
+static const Encoded inks[INK_ANY] = {
+    ENCODED(SGR_RESET), ENCODED(SGR_GREEN), ENCODED(SGR_RED),  ENCODED(SGR_YELLOW),
+    ENCODED(SGR_BLUE),  ENCODED(SGR_WHITE), ENCODED(SGR_CYAN),
+};
+
+// What a cell looks like. `columns` is how far the glyph moves the cursor when that is
+// certain (plain ASCII); emoji and box drawing widths depend on the terminal, so the next
+// cell is positioned explicitly after them.
+struct Glyph {
+    Encoded text;
+    int     ink;
+    int     columns;
+};
+
+enum GlyphId {
+    GLYPH_EMPTY = 0,
+    GLYPH_WALL,
+    GLYPH_IMMUNE_WALL,
+    GLYPH_POISON,
+    GLYPH_HEAD,
+    GLYPH_BODY,
+    GLYPH_GROWTH,
+    GLYPH_GATE,
+    GLYPH_UNKNOWN,
+    GLYPH_COUNT,
+};
+
+// Full glyphs, then the compact ASCII set
+static const Glyph glyphs[2][GLYPH_COUNT] = {{
+    {ENCODED("   "), INK_ANY, 3}, // Spaces look the same in any foreground colour
+    {ENCODED("███"), INK_WHITE, 0},
+    {ENCODED("▣▣▣"), INK_CYAN, 0},
+    {ENCODED("☠️  "), INK_RED, 0},
+    {ENCODED("🟨 "), INK_YELLOW, 0},
+    {ENCODED("🟩 "), INK_GREEN, 0},
+    {ENCODED("🍎 "), INK_YELLOW, 0},
+    {ENCODED(" 🚪 "), INK_BLUE, 0}, // 4 columns wide, overlapping the next cell
+    {ENCODED(" ? "), INK_DEFAULT, 3},
+}, {
+    {ENCODED("   "), INK_ANY, 3},
+    {ENCODED("###"), INK_WHITE, 3},
+    {ENCODED("###"), INK_CYAN, 3},
+    {ENCODED(" x "), INK_RED, 3},
+    {ENCODED(" @ "), INK_YELLOW, 3},
+    {ENCODED(" o "), INK_GREEN, 3},
+    {ENCODED(" + "), INK_YELLOW, 3},
+    {ENCODED("[ ]"), INK_BLUE, 3},
+    {ENCODED(" ? "), INK_DEFAULT, 3},
+}};
+
+static int glyphAt(const GameState &state, int y, int x) {
+    switch (cellAt(state, y, x)) {
+    case CELL_EMPTY:
+        return GLYPH_EMPTY;
+    case CELL_WALL:
+        return GLYPH_WALL;
+    case CELL_IMMUNE_WALL:
+        return GLYPH_IMMUNE_WALL;
+    case CELL_POISON:
+        return GLYPH_POISON;
+    case CELL_SNAKE:
+        return y == state.headY && x == state.headX ? GLYPH_HEAD : GLYPH_BODY;
+    case CELL_GROWTH:
+        return GLYPH_GROWTH;
+    case CELL_GATE:
+        return GLYPH_GATE;
+    default:
+        return GLYPH_UNKNOWN;
+    }
+}
+
+// Decimal digits of a non-negative `n`.
+static void appendNumber(std::string &out, int n) {
+    char digits[12];
+    int  count = 0;
+    do {
+        digits[count++] = (char)('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    while (count > 0)
+        out += digits[--count];
+}
+
+bool AnsiRenderer::sendPending(int fd, int &writes) {
+    size_t sent = 0;
+    bool   ok   = true;
+    while (sent < pending.size()) {
+        ssize_t n = write(fd, pending.data() + sent, pending.size() - sent);
+        writes++;
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            ok = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+        sent += n;
+    }
+    pending.erase(0, sent);
+    return ok;
+}
+
+bool AnsiRenderer::writeFrame(int fd) {
+    long long bytes = out.size();
+    if (pending.empty())
+        pending.swap(out); // Both buffers keep their capacity
+    else
+        pending += out;
+    int  writes = 0;
+    bool ok     = sendPending(fd, writes);
+    stats.record(bytes, writes);
+    reset();
+    return ok;
+}
+
+bool AnsiRenderer::flushPending(int fd) {
+    int writes = 0;
+    return sendPending(fd, writes);
+}
+
+void AnsiRenderer::enterScreen() { out += "\x1b[?1049h\x1b[?25l\x1b[2J"; }
+
+void AnsiRenderer::leaveScreen() { out += SGR_RESET "\x1b[?25h\x1b[?1049l"; }
+
+void AnsiRenderer::clearScreen() {
+    out += SGR_RESET "\x1b[2J";
+    ink = INK_DEFAULT;
+    for (int i = 0; i < ANSI_HUD_ROWS; ++i)
+        hudCache[i].clear();
+}
+
+// CUP to a new row, CHA within the row, nothing when the cursor is already there.
+void AnsiRenderer::cursorTo(int y, int x) {
+    if (y == row && x == col)
+        return;
+    out += "\x1b[";
+    if (y != row) {
+        appendNumber(out, y + 1);
+        out += ';';
+        appendNumber(out, x + 1);
+        out += 'H';
+    } else {
+        appendNumber(out, x + 1);
+        out += 'G';
+    }
+    row = y;
+    col = x;
+}
+
+void AnsiRenderer::setInk(int newInk) {
+    if (newInk == INK_ANY || newInk == ink)
+        return;
+    out.append(inks[newInk].bytes, inks[newInk].length);
+    ink = newInk;
+}
+
+void AnsiRenderer::moveTo(int y, int x) {
+    cursorTo(y, x);
+    row = col = -1; // The caller writes there
+}
+
+void AnsiRenderer::line(int y, int x, const char *fmt, ...) {
+    char    text[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+
+    if (y >= 0 && y < ANSI_HUD_ROWS) {
+        if (hudCache[y] == text)
+            return;
+        hudCache[y] = text;
+    }
+    setInk(INK_DEFAULT);
+    cursorTo(y, x);
+    out += text;
+    out += "\x1b[K";
+    row = col = ink = -1; // The text may wrap or set its own colours
+}
+
+void AnsiRenderer::drawCell(const GameState &state, int y, int x) {
+    const Glyph &glyph = glyphs[compact][glyphAt(state, y, x)];
+    cursorTo(y, x * 3);
+    setInk(glyph.ink);
+    out.append(glyph.text.bytes, glyph.text.length);
+    col = glyph.columns ? col + glyph.columns : -1;
+    // The gate glyph overlaps the next cell, which is drawn again over it
+    if (&glyph == &glyphs[0][GLYPH_GATE] && x + 1 < state.width)
+        drawCell(state, y, x + 1);
+}
+
+void AnsiRenderer::drawBoard(GameState &state, bool full) {
+    if (full || state.fullRedraw) {
+        // About 20 bytes a cell for a full frame; the buffer keeps this capacity
+        out.reserve(out.size() + (size_t)state.height * state.width * 20);
+        for (int y = 0; y < state.height; ++y)
+            for (int x = 0; x < state.width; ++x)
+                drawCell(state, y, x);
+    } else {
+        for (int i = 0; i < state.dirtyCount; ++i) {
+            int cell = state.dirtyCells[i];
+            drawCell(state, cell / state.width, cell % state.width);
+        }
+    }
+    setInk(INK_DEFAULT);
+    clearDamage(state);
+}
+
+// Same panel as snake_game's drawScoreboard() and drawMissionBoard().
+void AnsiRenderer::drawHud(const GameState &state, int highScore) {
+    int x     = state.width * 3 + 5;
+    int y     = 1;
+    int stage = state.currentStage;
+
+    line(y++, x, "----- SCOREBOARD -----");
+    line(y++, x, "🍎 Growth Items: %d pts", state.total_score_growth);
+    line(y++, x, "☠️  Poison Items: %d pts", state.total_score_poison);
+    line(y++, x, "🚪 Gates Used  : %d pts", state.total_score_gate);
+    line(y++, x, "----------------------");
+    line(y++, x, "🏆 Current Score: %d", currentScore(state));
+    line(y++, x, "⭐ High Score   : %d", highScore);
+    line(y++, x, "----------------------");
+
+    int itemTicks = itemTicksLeft(state);
+    int gateTicks = gateTicksLeft(state);
+    if (itemTicks > 0)
+        line(y++, x, "⏳ Items Despawn: %d ticks", itemTicks);
+    else
+        line(y++, x, "⏳ Items Despawn: N/A");
+    if (gateTicks > 0)
+        line(y++, x, "⏳ Gates Despawn: %d ticks", gateTicks);
+    else
+        line(y++, x, "⏳ Gates Despawn: N/A");
+    y++; // Gap before the mission panel
+
+    const GameRules &rules  = *state.rules;
+    auto             done   = [](bool reached) { return reached ? "✅" : "  "; };
+    int              length = state.snake.size();
+    line(y++, x, "-------- MISSION (Stage %d) --------", stage + 1);
+    line(y++, x, "🐍 Length: %d/%d (%s) (Max: %d)", length, rules.mission_length_per_stage[stage],
+         done(length >= rules.mission_length_per_stage[stage]), state.maxLengthAchieved);
+    line(y++, x, "🍎 Growth: %d/%d (%s)", state.collected_growth_items,
+         rules.mission_growth_per_stage[stage],
+         done(state.collected_growth_items >= rules.mission_growth_per_stage[stage]));
+    line(y++, x, "☠️  Poison: %d/%d (%s)", state.collected_poison_items,
+         rules.mission_poison_per_stage[stage],
+         done(state.collected_poison_items >= rules.mission_poison_per_stage[stage]));
+    line(y++, x, "🚪 Gates : %d/%d (%s)", state.gates_used_count,
+         rules.mission_gate_per_stage[stage],
+         done(state.gates_used_count >= rules.mission_gate_per_stage[stage]));
+    line(y++, x, "----------------------------------");
+    line(y++, x, "⏱️  Turns Left: %d",
+         rules.stageTurnLimitPerStage[stage] - state.stageTurnCounter);
+    if (checkMissionClear(state))
+        line(y++, x, SGR_GREEN "\x1b[1m🎉 MISSION COMPLETE! 🎉" SGR_RESET);
+    else
+        line(y++, x, "   (Keep Going!)");
+    line(y++, x, "----------------------------------");
+}
@@ -0,0 +1,78 @@
+// ansi_renderer.h - ncurses 없이 ANSI 이스케이프 시퀀스로 게임 화면을 그리는 렌더러
+// 한 프레임을 바이트 버퍼에 모아 두고, 호출하는 쪽이 write() 한 번으로 내보낸다.
+// 한 프로세스가 여러 터미널을 상대하는 서버와 snake_game --render ansi 에서 쓴다.
+// 칸 모양과 색은 curses_board.cpp 의 drawCell() / initColors() 와 같다.
+// 칸 글리프와 색 시퀀스는 미리 인코딩해 둔 표에서 복사하고, 프레임 안에서 커서 위치와 현재 색을
+// 기억해서 필요 없는 이동/색 시퀀스는 내보내지 않는다. 버퍼는 비워도 용량을 유지한다.
+
+#ifndef ANSI_RENDERER_H
+#define ANSI_RENDERER_H
+
+#include "snake_engine.h"
+
+#include <string>
+
+#define ANSI_HUD_ROWS 34
+
+// Frames written by AnsiRenderer::writeFrame(): size and write() calls
+struct FrameStats {
+    long long frames   = 0;
+    long long bytes    = 0;
+    long long writes   = 0;
+    long long maxBytes = 0;
+
+    void record(long long frameBytes, int frameWrites) {
+        frames++;
+        bytes += frameBytes;
+        writes += frameWrites;
+        if (frameBytes > maxBytes)
+            maxBytes = frameBytes;
+    }
+    double bytesPerFrame() const { return frames ? (double)bytes / frames : 0.0; }
+    double writesPerFrame() const { return frames ? (double)writes / frames : 0.0; }
+};
+
+struct AnsiRenderer {
+    std::string out;             // Bytes of the frame being composed
+    std::string pending;         // Written frames a non-blocking fd hasn't taken yet
+    FrameStats  stats;           // Frames sent through writeFrame()
+    bool        compact = false; // ASCII glyphs for slow links; redraw everything on change
+
+    // Starts a new frame; the previous one must have been written out. The terminal's
+    // cursor and colour are taken as unknown again.
+    void reset() {
+        out.clear();
+        row = col = ink = -1;
+    }
+    // Writes the frame to `fd`, records it in `stats` and starts a new one. What a
+    // non-blocking `fd` doesn't take stays in `pending` and goes out first next time.
+    // False if the write failed.
+    bool writeFrame(int fd);
+    bool flushPending(int fd); // As much of `pending` as `fd` takes
+
+    void enterScreen(); // Alternate screen, hidden cursor, cleared
+    void leaveScreen(); // Back to the normal screen with the cursor shown
+    void clearScreen(); // Also forgets what the HUD rows hold
+
+    void moveTo(int y, int x); // 0-based row and column, for text appended to `out`
+    // Text at (y, x), then clears the rest of the row. Rows below ANSI_HUD_ROWS remember
+    // their text and are skipped when it hasn't changed.
+    void line(int y, int x, const char *fmt, ...);
+
+    // Every cell when `full`, otherwise the engine's damage list. Clears the damage.
+    void drawBoard(GameState &state, bool full);
+    // Scoreboard and mission panel to the right of the board.
+    void drawHud(const GameState &state, int highScore);
+
+  private:
+    void drawCell(const GameState &state, int y, int x);
+    bool sendPending(int fd, int &writes);
+    void cursorTo(int y, int x);
+    void setInk(int newInk);
+
+    std::string hudCache[ANSI_HUD_ROWS];
+    int         row = -1, col = -1; // Where the cursor is in this frame, -1 when unknown
+    int         ink = -1;           // Colour in effect in this frame, -1 when unknown
+};
+
+#endif
@@ -0,0 +1,390 @@
+// autopilot.cpp - 자동 조종 구현
+
+#include "autopilot.h"
+
+#include <algorithm>
+
+static const int dy[4]           = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4]           = {0, 0, -1, 1};
+static const int opposite[4]     = {DOWN, UP, RIGHT, LEFT};
+static const int sideTurns[4][2] = {{LEFT, RIGHT}, {LEFT, RIGHT}, {UP, DOWN}, {UP, DOWN}};
+
+#define UNWANTED_POISON_COST 8 // Detour, in cells, worth taking to avoid a poison item
+
+// calculateExitDirection() with the snake out of the way, as the fields see the board. The
+// engine's choice also dodges the body, so moveTarget() asks the engine for the real one.
+static int layoutExitDirection(const std::vector<std::uint8_t> &blocked, int exit,
+                               const int step[4], int entryDirection) {
+    static const int clockwise[4]        = {RIGHT, LEFT, UP, DOWN};
+    static const int counterClockwise[4] = {LEFT, RIGHT, DOWN, UP};
+    const int        order[4]            = {entryDirection, clockwise[entryDirection],
+                                            counterClockwise[entryDirection],
+                                            opposite[entryDirection]};
+    for (int d : order)
+        if (!blocked[exit + step[d]])
+            return d;
+    return opposite[entryDirection];
+}
+
+void Autopilot::reset() {
+    height          = 0;
+    width           = 0;
+    stage           = -1;
+    lastTurnCounter = -1;
+    for (Field &field : fields)
+        field.valid = false;
+}
+
+// Walls only change with a new stage or a new game, spotted by the turn counter going back
+// to zero. A gate respawn turns the old gates back into walls and new gates come out of
+// walls, so it only changes the portals; the fields pick that up in syncField().
+void Autopilot::syncLayout(const GameState &state) {
+    bool sameStage = state.height == height && state.width == width &&
+                     state.currentStage == stage && state.stageTurnCounter >= lastTurnCounter;
+    bool sameGates = state.gateA == gateA && state.gateB == gateB;
+    lastTurnCounter = state.stageTurnCounter;
+    if (sameStage && sameGates)
+        return;
+
+    if (!sameStage) {
+        height  = state.height;
+        width   = state.width;
+        stage   = state.currentStage;
+        stride  = width + 2;
+        step[0] = -stride;
+        step[1] = stride;
+        step[2] = -1;
+        step[3] = 1;
+        int area = (height + 2) * stride;
+        blocked.assign(area, 1); // The padding ring stands in for bounds checks
+        for (int i = 0; i < height * width; ++i) {
+            int cell           = state.map[i];
+            blocked[padded(i)] = cell == CELL_WALL || cell == CELL_IMMUNE_WALL || cell == CELL_GATE;
+        }
+        portalEntry.assign(area, 0);
+        portalExit.assign(area, 0);
+        portals.clear();
+        queue.resize(area);
+        if ((int)seen.size() != area) {
+            seen.assign(area, 0);
+            floodMark = 0;
+        }
+        for (Field &field : fields)
+            field.valid = false;
+    }
+
+    // Stepping from `entry` in direction d into one gate lands on `exit` outside the other
+    for (const Portal &portal : portals) {
+        portalEntry[portal.entry] = 0;
+        portalExit[portal.exit]   = 0;
+    }
+    portals.clear();
+    gateA = state.gateA;
+    gateB = state.gateB;
+    if (gateA.first >= 0) {
+        const std::pair<int, int> ends[2][2] = {{gateA, gateB}, {gateB, gateA}};
+        for (const auto &end : ends) {
+            for (int d = 0; d < 4; ++d) {
+                int entry = padded(end[0].first * width + end[0].second) - step[d];
+                if (blocked[entry])
+                    continue;
+                int gate = padded(end[1].first * width + end[1].second);
+                int exit = gate + step[layoutExitDirection(blocked, gate, step, d)];
+                if (blocked[exit])
+                    continue;
+                portals.push_back({entry, exit});
+                portalEntry[entry] = 1;
+                portalExit[exit]   = 1;
+            }
+        }
+    }
+}
+
+void Autopilot::currentSources(const GameState &state, int goal, std::vector<int> &out) const {
+    out.clear();
+    if (goal == GOAL_GATE) {
+        if (state.gateA.first >= 0) {
+            out.push_back(padded(state.gateA.first * width + state.gateA.second));
+            out.push_back(padded(state.gateB.first * width + state.gateB.second));
+        }
+    } else {
+        int type = goal == GOAL_GROWTH ? CELL_GROWTH : CELL_POISON;
+        for (int i = 0; i < state.itemCount; ++i)
+            if (state.map[state.items[i].cell] == type)
+                out.push_back(padded(state.items[i].cell));
+    }
+    std::sort(out.begin(), out.end());
+}
+
+// BFS that only ever shortens distances. `seeds` already hold their final distance and are
+// sorted by it; merging them with the FIFO keeps cells leaving in distance order, so each
+// cell is queued at most once. Portal exits also relax the cells that teleport onto them.
+void Autopilot::relax(Field &field) {
+    // Locals, so the stores into dist don't force the vectors to be reloaded
+    int                *dist      = field.dist.data();
+    int                *fifo      = queue.data();
+    const int          *seed      = seeds.data();
+    const int          *seedEnd   = seed + seeds.size();
+    const std::uint8_t *wall      = blocked.data();
+    const std::uint8_t *exits     = portalExit.data();
+    const int           offset[4] = {step[0], step[1], step[2], step[3]};
+    int                 head = 0, tail = 0;
+    for (;;) {
+        int cell;
+        if (seed < seedEnd && (head == tail || dist[*seed] <= dist[fifo[head]]))
+            cell = *seed++;
+        else if (head < tail)
+            cell = fifo[head++];
+        else
+            break;
+        int next = dist[cell] + 1;
+        for (int d = 0; d < 4; ++d) {
+            int neighbor = cell + offset[d];
+            if (!wall[neighbor] && next < dist[neighbor]) {
+                dist[neighbor] = next;
+                fifo[tail++]   = neighbor;
+            }
+        }
+        if (exits[cell]) {
+            for (const Portal &portal : portals) {
+                if (portal.exit == cell && next < dist[portal.entry]) {
+                    dist[portal.entry] = next;
+                    fifo[tail++]       = portal.entry;
+                }
+            }
+        }
+    }
+}
+
+void Autopilot::rebuild(int goal, const std::vector<int> &sources) {
+    Field &field = fields[goal];
+    field.dist.assign((height + 2) * stride, AUTOPILOT_FAR);
+    seeds = sources;
+    for (int cell : sources)
+        field.dist[cell] = 0;
+    relax(field);
+    field.sources = sources;
+    field.portals = portals;
+    field.valid   = true;
+    fullRebuilds++;
+}
+
+// Forgets every distance that may have been measured through the cells in `region`: whatever
+// is reachable from them along edges that add exactly one step. Cells outside keep a shortest
+// path that avoids the region, so the ones bordering it are exact and become the seeds.
+void Autopilot::dropRegion(Field &field) {
+    int *dist = field.dist.data();
+    for (std::pair<int, int> &root : region) {
+        root.second      = dist[root.first];
+        dist[root.first] = AUTOPILOT_FAR;
+    }
+    for (size_t i = 0; i < region.size(); ++i) {
+        int cell = region[i].first, next = region[i].second + 1;
+        for (int d = 0; d < 4; ++d) {
+            int neighbor = cell + step[d];
+            if (dist[neighbor] == next) {
+                region.push_back({neighbor, next});
+                dist[neighbor] = AUTOPILOT_FAR;
+            }
+        }
+        if (portalExit[cell]) {
+            for (const Portal &portal : portals) {
+                if (portal.exit == cell && dist[portal.entry] == next) {
+                    region.push_back({portal.entry, next});
+                    dist[portal.entry] = AUTOPILOT_FAR;
+                }
+            }
+        }
+    }
+
+    for (const std::pair<int, int> &reset : region) {
+        int cell = reset.first;
+        for (int d = 0; d < 4; ++d) // Gates are blocked but hold distance 0 as targets
+            if (dist[cell + step[d]] < AUTOPILOT_FAR)
+                seeds.push_back(cell + step[d]);
+        if (portalEntry[cell]) {
+            for (const Portal &portal : portals)
+                if (portal.entry == cell && dist[portal.exit] < AUTOPILOT_FAR)
+                    seeds.push_back(portal.exit);
+        }
+    }
+}
+
+static bool hasPortal(const std::vector<Autopilot::Portal> &list, const Autopilot::Portal &portal) {
+    return std::find(list.begin(), list.end(), portal) != list.end();
+}
+
+// Targets and portals that went away clear the distances that went through them; new ones are
+// relaxed from where they appeared. Either way only the cells whose distance changes, plus
+// ties, are visited.
+void Autopilot::syncField(const GameState &state, int goal) {
+    Field &field = fields[goal];
+    currentSources(state, goal, scratch);
+    if (scratch == field.sources && field.portals == portals && field.valid)
+        return;
+    bool kept = false; // Some old target is still there
+    for (int cell : scratch)
+        kept = kept || std::binary_search(field.sources.begin(), field.sources.end(), cell);
+    if (!field.valid || !kept) {
+        rebuild(goal, scratch); // Clearing would reach every cell anyway
+        return;
+    }
+
+    int *dist = field.dist.data();
+    region.clear();
+    seeds.clear();
+    for (int cell : field.sources)
+        if (!std::binary_search(scratch.begin(), scratch.end(), cell))
+            region.push_back({cell, 0});
+    for (const Portal &portal : field.portals)
+        if (!hasPortal(portals, portal) && dist[portal.entry] < AUTOPILOT_FAR &&
+            dist[portal.entry] == dist[portal.exit] + 1)
+            region.push_back({portal.entry, 0});
+    dropRegion(field);
+
+    for (int cell : scratch) {
+        if (!std::binary_search(field.sources.begin(), field.sources.end(), cell)) {
+            dist[cell] = 0;
+            seeds.push_back(cell);
+        }
+    }
+    for (const Portal &portal : portals)
+        if (!hasPortal(field.portals, portal) && dist[portal.exit] < AUTOPILOT_FAR)
+            seeds.push_back(portal.exit);
+    std::sort(seeds.begin(), seeds.end(), [dist](int a, int b) {
+        return dist[a] != dist[b] ? dist[a] < dist[b] : a < b;
+    });
+    seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+    relax(field);
+    field.sources = scratch;
+    field.portals = portals;
+    incrementalUpdates++;
+}
+
+// Where the head ends up moving `dir`, following a gate if it enters one.
+int Autopilot::moveTarget(const GameState &state, int dir, bool &fatal) const {
+    fatal = true;
+    int y = state.headY + dy[dir], x = state.headX + dx[dir];
+    if (y < 0 || y >= height || x < 0 || x >= width)
+        return -1;
+    int cell = cellAt(state, y, x);
+    if (cell == CELL_WALL || cell == CELL_IMMUNE_WALL || cell == CELL_SNAKE)
+        return -1;
+    if (cell == CELL_POISON && state.snake.size() <= 3)
+        return -1; // Would end the game on length < 3
+
+    if (cell == CELL_GATE) {
+        if (gateOnCooldown(state))
+            return -1;
+        // Timers run before the move, so a respawn due now turns this gate back into a wall
+        if (state.timers.active(state.gateTimer) && state.timers.remaining(state.gateTimer) == 1)
+            return -1;
+        std::pair<int, int> other =
+            (y == state.gateA.first && x == state.gateA.second) ? state.gateB : state.gateA;
+        int exitDir = calculateExitDirection(state, other.first, other.second, dir);
+        y           = other.first + dy[exitDir];
+        x           = other.second + dx[exitDir];
+        if (y < 0 || y >= height || x < 0 || x >= width)
+            return -1;
+        int exitCell = cellAt(state, y, x);
+        if (exitCell == CELL_WALL || exitCell == CELL_IMMUNE_WALL || exitCell == CELL_SNAKE)
+            return -1;
+    }
+    fatal = false;
+    return y * width + x;
+}
+
+// Free cells reachable from `start` once the head is there, counting at most `limit`.
+// Returns `limit` when the tail is reachable too: the snake can always follow it out.
+int Autopilot::roomAfter(const GameState &state, int start, int limit) {
+    if (++floodMark == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        floodMark = 1;
+    }
+    int tailCell = padded(state.snake.back());
+    int head = 0, count = 0;
+    queue[head++]                                       = start;
+    seen[start]                                         = floodMark;
+    seen[padded(state.headY * width + state.headX)] = floodMark;
+    for (int tail = 0; tail < head && count < limit; ++tail) {
+        int cell = queue[tail];
+        count++;
+        for (int d = 0; d < 4; ++d) {
+            int neighbor = cell + step[d];
+            if (seen[neighbor] == floodMark || blocked[neighbor])
+                continue;
+            if (neighbor == tailCell)
+                return limit;
+            if (state.map[(neighbor / stride - 1) * width + neighbor % stride - 1] == CELL_SNAKE)
+                continue;
+            seen[neighbor] = floodMark;
+            queue[head++]  = neighbor;
+        }
+    }
+    return count;
+}
+
+int Autopilot::choose(const GameState &state) {
+    syncLayout(state);
+
+    // The unfinished mission goal closest to the head
+    const GameRules &rules  = *state.rules;
+    int              st     = state.currentStage;
+    int              length = state.snake.size();
+    bool             need[GOAL_COUNT];
+    need[GOAL_GROWTH] = length < rules.mission_length_per_stage[st] ||
+                        state.collected_growth_items < rules.mission_growth_per_stage[st];
+    need[GOAL_POISON] =
+        state.collected_poison_items < rules.mission_poison_per_stage[st] && length > 3;
+    need[GOAL_GATE] =
+        state.gates_used_count < rules.mission_gate_per_stage[st] && state.gateA.first >= 0;
+    if (!need[GOAL_GROWTH] && !need[GOAL_POISON] && !need[GOAL_GATE])
+        need[GOAL_GROWTH] = true; // Points, at least
+
+    int headCell = padded(state.headY * width + state.headX);
+    int goal     = GOAL_GROWTH;
+    int goalDist = AUTOPILOT_FAR + 1;
+    for (int g = 0; g < GOAL_COUNT; ++g) {
+        if (!need[g])
+            continue;
+        syncField(state, g);
+        if (fields[g].dist[headCell] < goalDist) {
+            goal     = g;
+            goalDist = fields[g].dist[headCell];
+        }
+    }
+    const std::vector<int> &dist = fields[goal].dist;
+
+    // Straight first so ties keep the snake going; roomy moves before cramped ones
+    int       order[3] = {state.dirIndex, sideTurns[state.dirIndex][0],
+                          sideTurns[state.dirIndex][1]};
+    int       limit    = length + 1; // Room for the whole body
+    int       best     = NO_INPUT;
+    long long bestCost = 0;
+    for (int i = 0; i < 3; ++i) {
+        int dir = order[i];
+        if (dir == opposite[state.dirIndex])
+            continue;
+        bool fatal;
+        int  cell = moveTarget(state, dir, fatal);
+        if (fatal)
+            continue;
+        cell = padded(cell);
+
+        int       entered = cellAt(state, state.headY + dy[dir], state.headX + dx[dir]);
+        bool      reached = (goal == GOAL_GATE && entered == CELL_GATE) ||
+                       (goal == GOAL_GROWTH && entered == CELL_GROWTH) ||
+                       (goal == GOAL_POISON && entered == CELL_POISON);
+        int       room  = roomAfter(state, cell, limit);
+        long long steps = reached ? 0 : dist[cell];
+        if (entered == CELL_POISON && goal != GOAL_POISON)
+            steps += UNWANTED_POISON_COST;
+
+        long long cost = room < limit ? (1LL << 40) + (limit - room) : steps * 2 + (i > 0);
+        if (best == NO_INPUT || cost < bestCost) {
+            best     = dir;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
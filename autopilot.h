@@ -0,0 +1,85 @@
+// autopilot.h - BFS 거리장으로 뱀을 조종하는 자동 조종
+// 목표 종류(성장 아이템, 독 아이템, 게이트)마다 "가장 가까운 목표까지 몇 칸인지"를 모든 칸에
+// 적어 둔 거리장을 두고, 매 틱 머리 옆 칸 중 거리가 가장 짧고 안전한 칸으로 방향을 정한다.
+//
+// - 거리장은 벽과 게이트에만 의존한다. 뱀 몸은 계속 움직이므로 무시하고, 게이트는
+//   (몸을 뺀) calculateExitDirection() 규칙대로 "입구 옆 칸 -> 출구 밖 칸" 순간이동 간선으로 넣는다.
+// - 목표나 순간이동 간선이 사라지면 거기서 "거리가 딱 1씩 느는" 간선으로 닿는 칸만 지우고
+//   경계에서 다시 채운다. 새 목표/간선은 거리가 줄어드는 칸만 고친다. 게이트가 다시 생기는
+//   것은 간선 변경일 뿐이고, 스테이지나 게임이 바뀔 때만 전체를 다시 계산한다.
+// - 격자는 테두리 한 칸을 막힌 칸으로 덧댄(padded) 인덱스를 써서 범위 검사가 없다.
+// - 안전 검사는 다음 칸에서 뱀 길이만큼만 flood fill 하므로 보드 크기와 상관없다.
+
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "snake_engine.h"
+
+#include <cstdint>
+#include <vector>
+
+#define AUTOPILOT_FAR 0x3fffffff // Distance of a cell that can't reach any target
+
+enum AutopilotGoal {
+    GOAL_GROWTH = 0,
+    GOAL_POISON,
+    GOAL_GATE,
+    GOAL_COUNT,
+};
+
+struct Autopilot {
+    // Direction for this tick, as updateDirection() accepts it; never a U-turn.
+    // NO_INPUT when every move is fatal.
+    int choose(const GameState &state);
+
+    // Drops the cached fields, e.g. before reusing the autopilot for a new game.
+    void reset();
+
+    long long fullRebuilds       = 0; // Fields recomputed from scratch
+    long long incrementalUpdates = 0; // Target changes patched in place
+
+    struct Portal {
+        int entry; // Cell next to a gate the snake moves from
+        int exit;  // Cell outside the other gate it lands on
+
+        bool operator==(const Portal &other) const {
+            return entry == other.entry && exit == other.exit;
+        }
+    };
+
+  private:
+    struct Field {
+        std::vector<int>    dist;
+        std::vector<int>    sources; // Sorted target cells the field was built from
+        std::vector<Portal> portals; // Portals the field was built with
+        bool                valid = false;
+    };
+
+    void syncLayout(const GameState &state);
+    void syncField(const GameState &state, int goal);
+    void currentSources(const GameState &state, int goal, std::vector<int> &out) const;
+    void rebuild(int goal, const std::vector<int> &sources);
+    void relax(Field &field); // BFS from `seeds` keeping shorter paths
+    void dropRegion(Field &field); // Clears what was reached through `region`
+    int  moveTarget(const GameState &state, int dir, bool &fatal) const;
+    int  roomAfter(const GameState &state, int start, int limit);
+    int  padded(int cell) const { return (cell / width + 1) * stride + cell % width + 1; }
+
+    int                        height = 0, width = 0;
+    int                        stride  = 0; // Row length of the padded grids below
+    int                        step[4] = {}; // Padded offset of each direction
+    int                        stage           = -1;
+    int                        lastTurnCounter = -1;
+    std::pair<int, int>        gateA = {-1, -1}, gateB = {-1, -1};
+    std::vector<std::uint8_t>  blocked;    // Wall or gate: only crossed through portals
+    std::vector<std::uint8_t>  portalEntry; // Cell is the entry of some portal
+    std::vector<std::uint8_t>  portalExit;  // Cell is the exit of some portal
+    std::vector<Portal>        portals;
+    Field                      fields[GOAL_COUNT];
+    std::vector<int>           queue, seeds, scratch;
+    std::vector<std::pair<int, int>> region; // Cells being cleared and their old distance
+    std::vector<std::uint32_t> seen; // Flood fill marks, compared against floodMark
+    std::uint32_t              floodMark = 0;
+};
+
+#endif
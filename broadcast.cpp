@@ -0,0 +1,537 @@
+// broadcast.cpp - 구경꾼 스트림 인코딩, 송신 스레드, 뷰어 쪽 디코딩
+
+#include "broadcast.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define WATCH_IOV_BATCH 16 // Messages per writev()
+
+// --- Encoding helpers ---
+
+static void putByte(std::vector<std::uint8_t> &out, unsigned value) {
+    out.push_back((std::uint8_t)value);
+}
+
+static void putU16(std::vector<std::uint8_t> &out, unsigned value) {
+    putByte(out, value & 0xff);
+    putByte(out, (value >> 8) & 0xff);
+}
+
+static void putVarint(std::vector<std::uint8_t> &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        putByte(out, (value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    putByte(out, (unsigned)value);
+}
+
+// Zigzag: small negative numbers stay short too
+static void putSigned(std::vector<std::uint8_t> &out, long long value) {
+    putVarint(out, ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63));
+}
+
+static void readCounters(const GameState &state, int highScore, int *now) {
+    now[WATCH_HEAD]          = state.headY * state.width + state.headX;
+    now[WATCH_STAGE]         = state.currentStage;
+    now[WATCH_LENGTH]        = state.snake.size();
+    now[WATCH_MAX_LENGTH]    = state.maxLengthAchieved;
+    now[WATCH_SCORE]         = currentScore(state);
+    now[WATCH_HIGH_SCORE]    = highScore;
+    now[WATCH_GROWTH_POINTS] = state.total_score_growth;
+    now[WATCH_POISON_POINTS] = state.total_score_poison;
+    now[WATCH_GATE_POINTS]   = state.total_score_gate;
+    now[WATCH_GROWTH_ITEMS]  = state.collected_growth_items;
+    now[WATCH_POISON_ITEMS]  = state.collected_poison_items;
+    now[WATCH_GATES_USED]    = state.gates_used_count;
+    now[WATCH_TURNS_USED]    = state.stageTurnCounter;
+    now[WATCH_ITEM_TICKS]    = itemTicksLeft(state);
+    now[WATCH_GATE_TICKS]    = gateTicksLeft(state);
+}
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+// --- Game thread ---
+
+void Broadcaster::beginGame(const std::string &playerName) {
+    name        = playerName.substr(0, WATCH_MAX_NAME);
+    tick        = 0;
+    keyframeDue = true;
+}
+
+void Broadcaster::publish(const GameState &state, int highScore) {
+    tick++;
+    if (listenFd < 0)
+        return;
+    if (spectatorCount.load(std::memory_order_acquire) == 0) {
+        keyframeDue = true; // Nothing is encoded until someone watches
+        return;
+    }
+    if (keyframeWanted.exchange(false, std::memory_order_acq_rel))
+        keyframeDue = true;
+
+    int now[WATCH_COUNTERS];
+    readCounters(state, highScore, now);
+    // A new stage replaces the whole board; so does a delta chain as long as a keyframe
+    if (keyframeDue || now[WATCH_STAGE] != counters[WATCH_STAGE] || chainBytes > keyframeBytes)
+        encodeKeyframe(state, now);
+    else if (encodeDelta(state, now))
+        send(WATCH_DELTA, false);
+}
+
+void Broadcaster::endGame(const GameState &state) {
+    if (listenFd < 0 || spectatorCount.load(std::memory_order_acquire) == 0)
+        return;
+    payload.clear();
+    putVarint(payload, tick);
+    putByte(payload, state.gameOverReason);
+    putByte(payload, state.gameWon);
+    putSigned(payload, finalScore(state));
+    send(WATCH_END, false);
+}
+
+void Broadcaster::encodeKeyframe(const GameState &state, const int *now) {
+    payload.clear();
+    putVarint(payload, tick);
+    putU16(payload, state.height);
+    putU16(payload, state.width);
+    putByte(payload, name.size());
+    payload.insert(payload.end(), name.begin(), name.end());
+    for (int i = 0; i < WATCH_COUNTERS; ++i)
+        putSigned(payload, now[i]);
+    // Runs of equal cells: walls and floor come in long stretches
+    int cells = state.height * state.width;
+    for (int i = 0; i < cells;) {
+        int run = 1;
+        while (i + run < cells && state.map[i + run] == state.map[i])
+            run++;
+        putByte(payload, state.map[i]);
+        putVarint(payload, run);
+        i += run;
+    }
+
+    shadow = state.map;
+    std::copy(now, now + WATCH_COUNTERS, counters);
+    keyframeDue   = false;
+    keyframeBytes = payload.size();
+    chainBytes    = 0;
+    keyframes++;
+    send(WATCH_KEYFRAME, true);
+}
+
+// Cells on the damage list that differ from what was last sent, and counters that
+// changed; false when there is nothing to send.
+bool Broadcaster::encodeDelta(const GameState &state, const int *now) {
+    changed.clear();
+    for (int i = 0; i < state.dirtyCount; ++i) {
+        CellIndex cell = state.dirtyCells[i];
+        if (state.map[cell] != shadow[cell]) {
+            shadow[cell] = state.map[cell];
+            changed.push_back(cell);
+        }
+    }
+    unsigned mask = 0;
+    for (int i = 0; i < WATCH_COUNTERS; ++i)
+        if (now[i] != counters[i])
+            mask |= 1u << i;
+    if (changed.empty() && mask == 0)
+        return false;
+
+    payload.clear();
+    putVarint(payload, tick);
+    putVarint(payload, mask);
+    for (int i = 0; i < WATCH_COUNTERS; ++i)
+        if (mask & (1u << i))
+            putSigned(payload, counters[i] = now[i]);
+    std::sort(changed.begin(), changed.end()); // Gaps between sorted cells are short
+    putVarint(payload, changed.size());
+    CellIndex previous = 0;
+    for (CellIndex cell : changed) {
+        putVarint(payload, cell - previous);
+        putByte(payload, shadow[cell]);
+        previous = cell;
+    }
+    chainBytes += payload.size();
+    return true;
+}
+
+// Frames the payload and hands it to the sender thread. If the queue is full the
+// spectators have missed a message, so the next one is a keyframe.
+void Broadcaster::send(int type, bool keyframe) {
+    auto frame = std::make_shared<std::vector<std::uint8_t>>();
+    frame->reserve(payload.size() + 6);
+    putByte(*frame, type);
+    putVarint(*frame, payload.size());
+    frame->insert(frame->end(), payload.begin(), payload.end());
+    if (!queue.push({frame, keyframe})) {
+        overflows++;
+        keyframeDue = true;
+        return;
+    }
+    messages++;
+    bytes += frame->size();
+    char wake = 0;
+    if (write(wakeFds[1], &wake, 1) < 0) {
+        // The pipe is full, so the sender thread is awake already
+    }
+}
+
+// --- Sender thread ---
+
+bool Broadcaster::start(const char *socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, socketPath);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return false;
+    unlink(socketPath); // Left over from a game that didn't shut down cleanly
+    if (bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, 64) != 0 ||
+        pipe(wakeFds) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    setNonBlocking(listenFd);
+    setNonBlocking(wakeFds[0]);
+    setNonBlocking(wakeFds[1]);
+    path = socketPath;
+
+    auto stream = std::make_shared<std::vector<std::uint8_t>>(WATCH_MAGIC, WATCH_MAGIC + 4);
+    putByte(*stream, WATCH_VERSION);
+    header = stream;
+
+    running.store(true, std::memory_order_release);
+    sender = std::thread(&Broadcaster::run, this);
+    return true;
+}
+
+void Broadcaster::stop() {
+    if (!running.exchange(false, std::memory_order_acq_rel))
+        return;
+    char wake = 0;
+    if (write(wakeFds[1], &wake, 1) < 0) {
+        // Already awake
+    }
+    sender.join();
+    for (Spectator &s : spectators)
+        close(s.fd);
+    spectators.clear();
+    close(listenFd);
+    close(wakeFds[0]);
+    close(wakeFds[1]);
+    listenFd = wakeFds[0] = wakeFds[1] = -1;
+    unlink(path.c_str());
+}
+
+void Broadcaster::run() {
+    std::vector<pollfd> fds;
+    std::vector<bool>   gone;
+    while (running.load(std::memory_order_acquire)) {
+        fds.clear();
+        fds.push_back({wakeFds[0], POLLIN, 0});
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const Spectator &s : spectators)
+            fds.push_back({s.fd, (short)(POLLIN | (s.queued ? POLLOUT : 0)), 0});
+        if (poll(fds.data(), fds.size(), WATCH_POLL_MS) < 0 && errno != EINTR)
+            break;
+
+        char drain[256];
+        while (read(wakeFds[0], drain, sizeof(drain)) > 0) {
+        }
+        Message message;
+        while (queue.pop(message))
+            deliver(message);
+
+        // Spectators send nothing; readable means they hung up
+        gone.assign(spectators.size(), false);
+        for (size_t i = 0; i < spectators.size(); ++i) {
+            Spectator &s = spectators[i];
+            if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t n = read(s.fd, drain, sizeof(drain));
+                gone[i]   = n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR);
+            }
+            if (!gone[i])
+                gone[i] = !flush(s);
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < spectators.size(); ++i) {
+            if (gone[i])
+                close(spectators[i].fd);
+            else if (kept++ != i)
+                spectators[kept - 1] = std::move(spectators[i]);
+        }
+        spectators.erase(spectators.begin() + kept, spectators.end());
+        spectatorCount.store((int)kept, std::memory_order_release);
+
+        if (fds[1].revents & POLLIN)
+            accept();
+    }
+}
+
+void Broadcaster::accept() {
+    int fd;
+    while ((fd = ::accept(listenFd, nullptr, nullptr)) >= 0) {
+        if (spectators.size() >= WATCH_MAX_SPECTATORS) {
+            close(fd);
+            continue;
+        }
+        setNonBlocking(fd);
+        if (spectators.empty())
+            chain.clear(); // The game stopped encoding when the last spectator left
+
+        Spectator s;
+        s.fd = fd;
+        s.queue.push_back(header);
+        s.queued = header->size();
+        for (const WatchFrame &frame : chain) {
+            s.queue.push_back(frame);
+            s.queued += frame->size();
+        }
+        s.skipping = chain.empty(); // Deltas are no use until the next keyframe
+        spectators.push_back(std::move(s));
+        spectatorCount.store((int)spectators.size(), std::memory_order_release);
+        if ((long long)spectators.size() > peakSpectators)
+            peakSpectators = spectators.size();
+        if (chain.empty())
+            keyframeWanted.store(true, std::memory_order_release);
+    }
+}
+
+// Queues a reference to the message for every spectator; the bytes themselves are shared.
+void Broadcaster::deliver(const Message &message) {
+    if (message.keyframe)
+        chain.clear();
+    if (!chain.empty() || message.keyframe)
+        chain.push_back(message.frame);
+    size_t limit = WATCH_MAX_BACKLOG + (chain.empty() ? 0 : chain.front()->size());
+
+    for (Spectator &s : spectators) {
+        if (message.keyframe) {
+            dropBacklog(s); // The keyframe supersedes everything still queued
+            s.skipping = false;
+        } else if (s.skipping) {
+            continue;
+        }
+        s.queue.push_back(message.frame);
+        s.queued += message.frame->size();
+        if (s.queued > limit) {
+            dropBacklog(s);
+            s.skipping = true;
+            resyncs++;
+            keyframeWanted.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void Broadcaster::dropBacklog(Spectator &s) {
+    // A message cut short would break the stream, so a partly sent one stays, and so does an
+    // unsent stream header: the spectator reads nothing without it
+    bool keepFront = !s.queue.empty() && (s.offset > 0 || s.queue.front() == header);
+    while (s.queue.size() > (keepFront ? 1u : 0u)) {
+        s.queued -= s.queue.back()->size();
+        s.queue.pop_back();
+    }
+}
+
+bool Broadcaster::flush(Spectator &s) {
+    while (s.queued > 0) {
+        iovec  iov[WATCH_IOV_BATCH];
+        int    count  = 0;
+        size_t wanted = 0;
+        size_t offset = s.offset;
+        for (auto it = s.queue.begin(); it != s.queue.end() && count < WATCH_IOV_BATCH; ++it) {
+            iov[count].iov_base = (void *)((*it)->data() + offset);
+            iov[count].iov_len  = (*it)->size() - offset;
+            wanted += iov[count++].iov_len;
+            offset = 0;
+        }
+        ssize_t n = writev(s.fd, iov, count);
+        if (n < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+        s.queued -= n;
+        size_t sent = n;
+        while (sent > 0) {
+            size_t rest = s.queue.front()->size() - s.offset;
+            if (sent < rest) {
+                s.offset += sent;
+                break;
+            }
+            sent -= rest;
+            s.queue.pop_front();
+            s.offset = 0;
+        }
+        if ((size_t)n < wanted)
+            return true; // The socket is full; poll() says when it drains
+    }
+    return true;
+}
+
+// --- Viewer side ---
+
+struct WatchReader {
+    const std::uint8_t *data;
+    size_t              size;
+    size_t              pos = 0;
+    bool                ok  = true;
+
+    unsigned byte() {
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+    unsigned u16() {
+        unsigned low = byte();
+        return low | (byte() << 8);
+    }
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned b = byte();
+            value |= (std::uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+    long long svarint() {
+        std::uint64_t value = varint();
+        return (long long)(value >> 1) ^ -(long long)(value & 1);
+    }
+};
+
+static void moveHead(WatchView &view, int head) {
+    GameState &board = view.board;
+    markDirty(board, board.headY * board.width + board.headX);
+    board.headY = head / board.width;
+    board.headX = head % board.width;
+    markDirty(board, head);
+}
+
+static bool applyKeyframe(WatchView &view, WatchReader &in) {
+    view.tick  = in.varint();
+    int height = in.u16();
+    int width  = in.u16();
+    if (height < MIN_BOARD_SIZE || height > MAX_BOARD_SIZE || width < MIN_BOARD_SIZE ||
+        width > MAX_BOARD_SIZE)
+        return false;
+    unsigned length = in.byte();
+    if (!in.ok || in.size - in.pos < length)
+        return false;
+    view.name.assign((const char *)in.data + in.pos, length);
+    in.pos += length;
+    for (int i = 0; i < WATCH_COUNTERS; ++i)
+        view.counters[i] = (int)in.svarint();
+
+    GameState &board = view.board;
+    int        cells = height * width;
+    board.height     = height;
+    board.width      = width;
+    board.map.assign(cells, CELL_EMPTY);
+    board.dirtyFlag.assign(cells, 0);
+    board.dirtyCells.assign(cells, 0);
+    board.dirtyCount = 0;
+    board.fullRedraw = true;
+    for (int i = 0; i < cells && in.ok;) {
+        unsigned      value = in.byte();
+        std::uint64_t run   = in.varint();
+        if (run == 0 || run > (std::uint64_t)(cells - i))
+            return false;
+        std::fill(board.map.begin() + i, board.map.begin() + i + run, (std::uint8_t)value);
+        i += (int)run;
+    }
+    int head = view.counters[WATCH_HEAD];
+    if (head < 0 || head >= cells)
+        return false;
+    board.headY = head / width;
+    board.headX = head % width;
+    view.ready  = true;
+    view.ended  = false;
+    return in.ok;
+}
+
+static bool applyDelta(WatchView &view, WatchReader &in) {
+    if (!view.ready)
+        return true; // Joined between keyframes; the sender doesn't do that, but it's harmless
+    GameState &board = view.board;
+    int        cells = board.height * board.width;
+    view.tick        = in.varint();
+    std::uint64_t mask = in.varint();
+    for (int i = 0; i < WATCH_COUNTERS; ++i) {
+        if (!(mask & (1u << i)))
+            continue;
+        int value = (int)in.svarint();
+        if (i == WATCH_HEAD) {
+            if (value < 0 || value >= cells)
+                return false;
+            moveHead(view, value);
+        }
+        view.counters[i] = value;
+    }
+    std::uint64_t count = in.varint();
+    std::uint64_t cell  = 0;
+    for (std::uint64_t i = 0; i < count && in.ok; ++i) {
+        cell += in.varint();
+        unsigned value = in.byte();
+        if (cell >= (std::uint64_t)cells)
+            return false;
+        board.map[cell] = (std::uint8_t)value;
+        markDirty(board, (int)cell);
+    }
+    return in.ok;
+}
+
+static bool applyEnd(WatchView &view, WatchReader &in) {
+    view.tick       = in.varint();
+    view.endReason  = in.byte();
+    view.won        = in.byte() != 0;
+    view.finalScore = (int)in.svarint();
+    view.ended      = true;
+    return in.ok;
+}
+
+int readWatchMessage(WatchView &view, const std::uint8_t *data, size_t size, size_t &used) {
+    used = 0;
+    if (!view.started) {
+        if (size < 5)
+            return 0;
+        if (memcmp(data, WATCH_MAGIC, 4) != 0 || data[4] != WATCH_VERSION)
+            return -1;
+        view.started = true;
+        used         = 5;
+        data += 5;
+        size -= 5;
+    }
+
+    WatchReader   frame{data, size};
+    unsigned      type   = frame.byte();
+    std::uint64_t length = frame.varint();
+    if (!frame.ok || size - frame.pos < length)
+        return 0; // Not all here yet; the header, if any, stays consumed
+    WatchReader payload{data + frame.pos, (size_t)length};
+    used += frame.pos + length;
+
+    bool ok = true;
+    if (type == WATCH_KEYFRAME)
+        ok = applyKeyframe(view, payload);
+    else if (type == WATCH_DELTA)
+        ok = applyDelta(view, payload);
+    else if (type == WATCH_END)
+        ok = applyEnd(view, payload);
+    return ok ? (int)type : -1;
+}
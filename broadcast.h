@@ -0,0 +1,164 @@
+// broadcast.h - 진행 중인 게임을 다른 터미널에서 구경하게 해 주는 중계
+// 게임은 유닉스 소켓(snake_watch.sock)을 열어 두고, snake_watch 가 여기에 붙는다.
+// 스트림: "SNKW" | version u8, 그 뒤로 메시지가 이어진다.
+//   메시지:    type u8 | length varint | payload
+//   KEYFRAME: tick varint | height u16 | width u16 | nameLength u8 | name
+//             | WATCH_COUNTERS x svarint | (cell value u8 | run varint) ... 보드 끝까지
+//   DELTA:    tick varint | counter mask varint | 바뀐 카운터 svarint ...
+//             | cellCount varint | cellCount x (varint(앞 칸과의 간격) | value u8)
+//   END:      tick varint | gameOverReason u8 | won u8 | finalScore svarint
+// svarint 는 zigzag 부호화한 varint 다. 모르는 type 은 length 만큼 건너뛰면 된다.
+//
+// 게임 스레드: 틱마다 damage list 중 지난번에 보낸 뒤 실제로 바뀐 칸과 HUD 카운터만 DELTA 로
+//             인코딩해 SPSC 링으로 넘긴다. 구경꾼이 없으면 인코딩하지 않는다.
+// 송신 스레드: 메시지 하나를 모든 구경꾼이 같은 버퍼(shared_ptr)로 공유하고, 구경꾼마다
+//             보낼 버퍼 목록만 들고 writev() 로 보낸다. 새 구경꾼은 마지막 KEYFRAME 과 그 뒤의
+//             DELTA 들을 받는다. 밀린 양이 WATCH_MAX_BACKLOG 를 넘은 구경꾼은 밀린 메시지를
+//             버리고 다음 KEYFRAME 부터 다시 받는다. 게임 스레드는 소켓을 건드리지 않으므로
+//             느린 구경꾼이 틱을 막지 않는다. 프로세스는 SIGPIPE 를 무시해야 한다.
+
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "snake_engine.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define WATCH_MAGIC          "SNKW"
+#define WATCH_VERSION        1
+#define DEFAULT_WATCH_SOCKET "snake_watch.sock"
+#define WATCH_QUEUE_SIZE     256          // Messages between the game and sender threads
+#define WATCH_MAX_BACKLOG    (256 * 1024) // Unsent bytes a spectator may have beyond a keyframe
+#define WATCH_MAX_NAME       64
+#define WATCH_MAX_SPECTATORS 256
+#define WATCH_POLL_MS        100
+
+enum WatchMessageType {
+    WATCH_KEYFRAME = 1,
+    WATCH_DELTA,
+    WATCH_END,
+};
+
+// HUD values sent with every keyframe, and in a delta when they change
+enum WatchCounter {
+    WATCH_HEAD = 0, // y * width + x
+    WATCH_STAGE,
+    WATCH_LENGTH,
+    WATCH_MAX_LENGTH,
+    WATCH_SCORE,        // currentScore()
+    WATCH_HIGH_SCORE,
+    WATCH_GROWTH_POINTS,
+    WATCH_POISON_POINTS,
+    WATCH_GATE_POINTS,
+    WATCH_GROWTH_ITEMS, // Collected this stage
+    WATCH_POISON_ITEMS,
+    WATCH_GATES_USED,
+    WATCH_TURNS_USED,
+    WATCH_ITEM_TICKS, // itemTicksLeft(), -1 when there is none
+    WATCH_GATE_TICKS, // gateTicksLeft()
+    WATCH_COUNTERS,
+};
+
+// One encoded message, shared by every spectator it is queued for
+typedef std::shared_ptr<const std::vector<std::uint8_t>> WatchFrame;
+
+struct Broadcaster {
+    // Game thread counters
+    long long messages  = 0; // Keyframes and deltas published
+    long long keyframes = 0;
+    long long bytes     = 0;
+    long long overflows = 0; // Messages the sender thread had no room for
+    // Sender thread counters, read after stop()
+    long long peakSpectators = 0;
+    long long resyncs        = 0; // Spectators that fell behind and skipped to a keyframe
+
+    ~Broadcaster() { stop(); }
+
+    // Listens on `path` and starts the sender thread. False if the socket can't be set up.
+    bool start(const char *path);
+    void stop();
+
+    // Game thread side. beginGame() before the first tick of a game, publish() after every
+    // step() (before the damage is drawn and cleared), endGame() once the game is over.
+    void beginGame(const std::string &name);
+    void publish(const GameState &state, int highScore);
+    void endGame(const GameState &state);
+
+  private:
+    struct Spectator {
+        int                    fd;
+        std::deque<WatchFrame> queue;            // Messages not fully sent, oldest first
+        size_t                 offset   = 0;     // Bytes of queue.front() already sent
+        size_t                 queued   = 0;     // Unsent bytes in the queue
+        bool                   skipping = false; // Waiting for a keyframe after falling behind
+    };
+    struct Message {
+        WatchFrame frame;
+        bool       keyframe;
+    };
+
+    void encodeKeyframe(const GameState &state, const int *now);
+    bool encodeDelta(const GameState &state, const int *now);
+    void send(int type, bool keyframe);
+
+    void run();
+    void accept();
+    void deliver(const Message &message);
+    void dropBacklog(Spectator &s); // Keeps only a partly sent message or the unsent header
+    bool flush(Spectator &s);       // False once the spectator is gone
+
+    // Game thread
+    std::vector<std::uint8_t> shadow;  // Cells as the spectators have them
+    int                       counters[WATCH_COUNTERS] = {};
+    std::string               name;
+    long long                 tick          = 0;
+    bool                      keyframeDue   = true;
+    size_t                    chainBytes    = 0; // Deltas since the last keyframe
+    size_t                    keyframeBytes = 0;
+    std::vector<CellIndex>    changed;
+    std::vector<std::uint8_t> payload; // Message being encoded
+
+    // Shared
+    std::atomic<int>                    spectatorCount{0};
+    std::atomic<bool>                   keyframeWanted{false};
+    std::atomic<bool>                   running{false};
+    SpscRing<Message, WATCH_QUEUE_SIZE> queue;
+    int                                 wakeFds[2] = {-1, -1}; // Game thread -> sender thread
+    int                                 listenFd   = -1;
+    std::string                         path;
+    std::thread                         sender;
+
+    // Sender thread
+    WatchFrame              header; // Stream header, queued first for every spectator
+    std::vector<WatchFrame> chain;  // Last keyframe and the deltas after it
+    std::vector<Spectator>  spectators;
+};
+
+// What snake_watch knows of the game: the board (map, head and damage, for
+// AnsiRenderer::drawBoard) and the HUD counters.
+struct WatchView {
+    GameState   board;
+    std::string name;
+    int         counters[WATCH_COUNTERS] = {};
+    long long   tick       = 0;
+    bool        started    = false; // Stream header checked
+    bool        ready      = false; // A keyframe has arrived
+    bool        ended      = false;
+    int         endReason  = 0;
+    bool        won        = false;
+    int         finalScore = 0;
+};
+
+// Applies the next complete message in data[0..size) to `view` and sets `used` to the bytes
+// it took, the stream header included the first time. Returns the message's type (unknown
+// types are skipped), 0 when more bytes are needed, or -1 when the stream is not valid.
+int readWatchMessage(WatchView &view, const std::uint8_t *data, size_t size, size_t &used);
+
+#endif
@@ -0,0 +1,92 @@
+// curses_board.cpp - ncurses 로 게임 보드 그리기
+
+#include "curses_board.h"
+
+#include <ncurses.h>
+
+void initColors() {
+    start_color();
+    // Pair 1: Snake Body (Green on Black)
+    init_pair(1, COLOR_GREEN, COLOR_BLACK);
+    // Pair 2: Poison Item / Game Over Message (Red on Black)
+    init_pair(2, COLOR_RED, COLOR_BLACK);
+    // Pair 3: Snake Head / Growth Item (Yellow on Black)
+    init_pair(3, COLOR_YELLOW, COLOR_BLACK);
+    // Pair 4: Gate (Blue on Black)
+    init_pair(4, COLOR_BLUE, COLOR_BLACK);
+    // Pair 5: Wall (White on Black)
+    init_pair(5, COLOR_WHITE, COLOR_BLACK);
+    // Pair 6: Immune Wall (Cyan on Black)
+    init_pair(6, COLOR_CYAN, COLOR_BLACK);
+    // Pair 7: Highlight / Selected Menu Item (Black on White or other contrast)
+    init_pair(7, COLOR_BLACK, COLOR_WHITE); // Example for selected menu
+    // Pair 8: General Text (White on Black - default, but can be explicit)
+    init_pair(8, COLOR_WHITE, COLOR_BLACK);
+}
+
+void drawCell(const GameState &state, int y, int x) {
+    move(y, x * 3);
+    int cell_type = cellAt(state, y, x);
+
+    switch (cell_type) {
+    case 0:
+        addstr("   ");
+        break;
+    case 1:
+        attron(COLOR_PAIR(5));
+        addstr("███");
+        attroff(COLOR_PAIR(5));
+        break;
+    case IMMUNE_WALL:
+        attron(COLOR_PAIR(6));
+        addstr("▣▣▣");
+        attroff(COLOR_PAIR(6));
+        break;
+    case 2: // Poison Item
+        attron(COLOR_PAIR(2));
+        addstr("☠️  ");
+        attroff(COLOR_PAIR(2)); // Ensure space for multi-byte char + space
+        break;
+    case 3: // Snake Body part
+        if (y == state.headY && x == state.headX) { // Head
+            attron(COLOR_PAIR(3));
+            addstr("🟨 ");
+            attroff(COLOR_PAIR(3));
+        } else { // Body
+            attron(COLOR_PAIR(1));
+            addstr("🟩 ");
+            attroff(COLOR_PAIR(1));
+        }
+        break;
+    case 4: // Growth Item
+        attron(COLOR_PAIR(3));
+        addstr("🍎 ");
+        attroff(COLOR_PAIR(3));
+        break;
+    case 5: // Gate
+        attron(COLOR_PAIR(4));
+        addstr(" 🚪 ");
+        attroff(COLOR_PAIR(4));
+        // The gate glyph is 4 columns wide and overlaps the next cell
+        if (x + 1 < state.width)
+            drawCell(state, y, x + 1);
+        break;
+    default:
+        addstr(" ? ");
+        break;
+    }
+}
+
+void drawBoard(GameState &state, bool full) {
+    if (full) {
+        for (int y = 0; y < state.height; ++y)
+            for (int x = 0; x < state.width; ++x)
+                drawCell(state, y, x);
+    } else {
+        for (int i = 0; i < state.dirtyCount; ++i) {
+            int cell = state.dirtyCells[i];
+            drawCell(state, cell / state.width, cell % state.width);
+        }
+    }
+    clearDamage(state);
+}
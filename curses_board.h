@@ -0,0 +1,19 @@
+// curses_board.h - ncurses 로 게임 보드 그리기
+// 칸 하나는 3열을 차지한다 (게이트 글리프만 4열이라 옆 칸을 다시 그린다).
+// snake_game 과 벤치마크(snake_bench)가 함께 쓴다. 색 번호는 ansi_renderer 와 같다.
+
+#ifndef CURSES_BOARD_H
+#define CURSES_BOARD_H
+
+#include "snake_engine.h"
+
+// Color pairs 1..8 used by the board and the rest of the UI. Needs an active screen.
+void initColors();
+
+// Draws the cell at (y, x) into stdscr.
+void drawCell(const GameState &state, int y, int x);
+
+// Every cell when `full`, otherwise the engine's damage list. Clears the damage.
+void drawBoard(GameState &state, bool full);
+
+#endif
@@ -0,0 +1,107 @@
+// free_cell_set.h - 빈 칸 인덱스 집합
+// 칸마다 비트 하나를 두고, 64칸 단위 개수를 펜윅 트리로 유지해서
+// 삽입/삭제/k번째 칸 선택을 O(log(칸 수 / 64))에 처리한다.
+// 선택은 칸 번호 순서를 따르므로 결과가 집합의 내용에만 달려 있다.
+
+#ifndef FREE_CELL_SET_H
+#define FREE_CELL_SET_H
+
+#include <cstdint>
+#include <vector>
+
+struct FreeCellSet {
+    std::vector<std::uint64_t> words; // One bit per cell, set while the cell is in the set
+    std::vector<int>           tree;  // Fenwick tree over the per-word counts, 1-based
+    int                        top   = 0; // Highest power of two below tree.size()
+    int                        count = 0;
+
+    // Sizes the set for a board of `cellCount` cells, all initially not free.
+    void reset(int cellCount) {
+        words.assign((cellCount + 63) / 64, 0);
+        tree.assign(words.size() + 1, 0);
+        for (top = 1; top * 2 < (int)tree.size();)
+            top *= 2;
+        count = 0;
+    }
+
+    void clear() {
+        words.assign(words.size(), 0);
+        tree.assign(tree.size(), 0);
+        count = 0;
+    }
+
+    bool contains(int cell) const { return (words[cell >> 6] >> (cell & 63)) & 1; }
+    int  size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void insert(int cell) {
+        if (contains(cell))
+            return;
+        words[cell >> 6] |= 1ULL << (cell & 63);
+        add(cell >> 6, 1);
+        count++;
+    }
+
+    void erase(int cell) {
+        if (!contains(cell))
+            return;
+        words[cell >> 6] &= ~(1ULL << (cell & 63));
+        add(cell >> 6, -1);
+        count--;
+    }
+
+    // Cells in the set below `cell`
+    int rank(int cell) const {
+        std::uint64_t below = byteCounts(words[cell >> 6] & ((1ULL << (cell & 63)) - 1));
+        int           total = (int)((below * 0x0101010101010101ULL) >> 56);
+        for (int i = cell >> 6; i > 0; i -= i & -i)
+            total += tree[i];
+        return total;
+    }
+
+    // The set's cell of rank `k` (0 <= k < size()), smallest cell first
+    int at(int k) const {
+        int word = 0;
+        for (int step = top; step > 0; step >>= 1) {
+            if (word + step < (int)tree.size() && tree[word + step] <= k) {
+                word += step;
+                k -= tree[word];
+            }
+        }
+        // Running byte totals find the byte, then drop the bits below the pick in it
+        std::uint64_t bits   = words[word];
+        std::uint64_t totals = byteCounts(bits) * 0x0101010101010101ULL;
+        int           byte   = 0;
+        while ((int)((totals >> (byte * 8)) & 0xff) <= k)
+            ++byte;
+        if (byte > 0)
+            k -= (totals >> (byte * 8 - 8)) & 0xff;
+        bits >>= byte * 8;
+        for (; k > 0; --k)
+            bits &= bits - 1;
+        return word * 64 + byte * 8 + __builtin_ctzll(bits);
+    }
+
+    // Calls fn(cell) for every cell in the set, smallest first
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int w = 0; w < (int)words.size(); ++w)
+            for (std::uint64_t bits = words[w]; bits; bits &= bits - 1)
+                fn(w * 64 + __builtin_ctzll(bits));
+    }
+
+    // Set bits in each byte of `bits`, one count per byte (no popcount instruction needed)
+    static std::uint64_t byteCounts(std::uint64_t bits) {
+        bits -= (bits >> 1) & 0x5555555555555555ULL;
+        bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+        return (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    }
+
+    // Adds `delta` to the count of word `word`
+    void add(int word, int delta) {
+        for (int i = word + 1; i < (int)tree.size(); i += i & -i)
+            tree[i] += delta;
+    }
+};
+
+#endif
@@ -0,0 +1,42 @@
+// game_rng.h - 게임 전용 난수 생성기 (PCG32)
+// 표준 라이브러리 분포/셔플은 구현마다 결과가 달라 clang 과 gcc 빌드 사이에서
+// 같은 시드로도 다른 판이 나온다. 상태 16바이트짜리 PCG32 와 직접 구현한 선택 함수만
+// 쓰므로 같은 시드와 입력이면 어느 빌드에서든 같은 판이 재현된다.
+
+#ifndef GAME_RNG_H
+#define GAME_RNG_H
+
+#include <cstdint>
+
+struct GameRng {
+    typedef std::uint32_t result_type;
+
+    std::uint64_t state = 0;
+    std::uint64_t inc   = 1; // Stream selector, always odd
+
+    GameRng() { seed(0); }
+
+    void seed(std::uint64_t seedValue, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        state = 0;
+        inc   = (stream << 1) | 1;
+        (*this)();
+        state += seedValue;
+        (*this)();
+    }
+
+    result_type operator()() {
+        std::uint64_t old        = state;
+        state                    = old * 6364136223846793005ULL + inc;
+        std::uint32_t xorshifted = (std::uint32_t)(((old >> 18) ^ old) >> 27);
+        std::uint32_t rot        = (std::uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffffu; }
+
+    // Uniform in [0, bound), bound > 0.
+    std::uint32_t below(std::uint32_t bound) { return (*this)() % bound; }
+};
+
+#endif
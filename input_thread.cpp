@@ -0,0 +1,94 @@
+// input_thread.cpp - 입력 스레드 구현
+// poll() 로 짧게 기다리며 읽으므로 stop() 은 최대 INPUT_POLL_MS 안에 끝난다.
+
+#include "input_thread.h"
+#include "tick_scheduler.h"
+
+#include <ncurses.h> // Key codes only; this thread never calls into ncurses
+#include <poll.h>
+#include <unistd.h>
+
+#define INPUT_POLL_MS 20
+
+void InputThread::start(int inputFd) {
+    stop();
+    fd      = inputFd;
+    decoder = KeyDecoder();
+    running.store(true, std::memory_order_release);
+    reader = std::thread(&InputThread::run, this);
+}
+
+void InputThread::stop() {
+    running.store(false, std::memory_order_release);
+    if (reader.joinable())
+        reader.join();
+}
+
+void InputThread::emit(int key) {
+    if (!events.push({key, monotonicNs()}))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+int keyToDirection(int key) {
+    switch (key) {
+    case KEY_UP:
+        return UP;
+    case KEY_DOWN:
+        return DOWN;
+    case KEY_LEFT:
+        return LEFT;
+    case KEY_RIGHT:
+        return RIGHT;
+    }
+    return NO_INPUT;
+}
+
+int KeyDecoder::feed(unsigned char c) {
+    if (state == 1) {
+        state = c == '[' ? 2 : c == 'O' ? 3 : 0;
+        if (state)
+            return -1;
+    } else if (state >= 2) {
+        if ((c >= '0' && c <= '9') || c == ';')
+            return -1;
+        bool csi = state == 2;
+        state    = 0;
+        switch (c) {
+        case 'A':
+            return KEY_UP;
+        case 'B':
+            return KEY_DOWN;
+        case 'C':
+            return KEY_RIGHT;
+        case 'D':
+            return KEY_LEFT;
+        case 'R':
+            return csi ? KEY_CURSOR_REPORT : -1; // ESC O R is F3
+        }
+        return -1;
+    }
+
+    if (c == 0x1b) {
+        state = 1;
+        return -1;
+    }
+    return c;
+}
+
+void InputThread::run() {
+    unsigned char buf[64];
+    while (running.load(std::memory_order_acquire)) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (::poll(&pfd, 1, INPUT_POLL_MS) <= 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+            continue;
+
+        for (ssize_t i = 0; i < n; ++i) {
+            int key = decoder.feed(buf[i]);
+            if (key >= 0)
+                emit(key);
+        }
+    }
+}
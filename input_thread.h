@@ -0,0 +1,124 @@
+// input_thread.h - 게임 중 키 입력 전용 스레드와 틱 단위 방향 전환 큐
+// 입력 스레드는 터미널에서 바로 바이트를 읽어 방향키 이스케이프 시퀀스를 풀고,
+// 시각을 붙인 KeyEvent 를 락프리 SPSC 링에 넣는다. ncurses 는 스레드 안전하지 않으므로
+// 입력 스레드는 ncurses 를 호출하지 않고, 게임 루프가 링을 비우며 처리한다.
+
+#ifndef INPUT_THREAD_H
+#define INPUT_THREAD_H
+
+#include "snake_engine.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <thread>
+
+#define KEY_QUEUE_SIZE  64 // Power of two
+#define TURN_QUEUE_SIZE 3  // Turns buffered ahead of the snake
+
+#define KEY_CURSOR_REPORT 0x10000 // ESC [ row ; col R, the answer to ESC [ 6 n
+
+struct KeyEvent {
+    int       key;    // ncurses key code (KEY_UP, ...) or the plain character
+    long long timeNs; // CLOCK_MONOTONIC time the key was read
+};
+
+// Turns raw terminal bytes into key codes. Arrow keys arrive as ESC [ A..D (or ESC O A..D
+// in application cursor mode), possibly with a modifier like ESC [ 1 ; 2 A. A cursor
+// position report comes back as KEY_CURSOR_REPORT.
+struct KeyDecoder {
+    // Returns the completed key, or -1 while inside an escape sequence.
+    int feed(unsigned char c);
+
+  private:
+    int state = 0; // Position inside an ESC [ x (2) or ESC O x (3) sequence
+};
+
+// Maps an arrow key to a Direction for step(); any other key is NO_INPUT.
+int keyToDirection(int key);
+
+struct InputThread {
+    ~InputThread() { stop(); }
+
+    // Starts reading `fd`, which must already be in cbreak/noecho mode.
+    void start(int fd);
+    // Joins the reader; keys typed afterwards are left for getch().
+    void stop();
+
+    // Game loop side: next key in arrival order.
+    bool poll(KeyEvent &event) { return events.pop(event); }
+    void discard() { events.drain(); }
+
+    long long droppedKeys() const { return dropped.load(std::memory_order_relaxed); }
+
+  private:
+    void run();
+    void emit(int key);
+
+    int                                fd = -1;
+    std::atomic<bool>                  running{false};
+    std::atomic<long long>             dropped{0};
+    std::thread                        reader;
+    KeyDecoder                         decoder;
+    SpscRing<KeyEvent, KEY_QUEUE_SIZE> events;
+};
+
+// Direction changes waiting for their tick. Each tick applies at most one, so two quick
+// turns inside one tick both land instead of the second overwriting the first.
+struct TurnQueue {
+    struct Turn {
+        int       dir;
+        long long timeNs;
+    };
+
+    Turn turns[TURN_QUEUE_SIZE];
+    int  head  = 0;
+    int  count = 0;
+
+    long long applied        = 0; // Turns handed to step()
+    long long dropped        = 0; // Turns lost because the queue was full
+    long long totalLatencyNs = 0; // Key read -> tick that applied it
+    long long maxLatencyNs   = 0;
+
+    void clear() { head = count = 0; }
+
+    // `heading` is the snake's current direction. A turn that repeats the direction the
+    // snake will already have by then is redundant and isn't queued.
+    void push(int dir, long long timeNs, int heading) {
+        int last = count ? turns[(head + count - 1) % TURN_QUEUE_SIZE].dir : heading;
+        if (dir == last)
+            return;
+        if (count == TURN_QUEUE_SIZE) {
+            dropped++;
+            return;
+        }
+        turns[(head + count++) % TURN_QUEUE_SIZE] = {dir, timeNs};
+    }
+
+    // The turn for the tick starting at `nowNs`, or NO_INPUT.
+    int pop(long long nowNs) {
+        if (count == 0)
+            return NO_INPUT;
+        Turn turn = turns[head];
+        head      = (head + 1) % TURN_QUEUE_SIZE;
+        count--;
+
+        long long latency = nowNs - turn.timeNs;
+        applied++;
+        totalLatencyNs += latency;
+        if (latency > maxLatencyNs)
+            maxLatencyNs = latency;
+        return turn.dir;
+    }
+
+    void mergeStats(const TurnQueue &other) {
+        applied += other.applied;
+        dropped += other.dropped;
+        totalLatencyNs += other.totalLatencyNs;
+        if (other.maxLatencyNs > maxLatencyNs)
+            maxLatencyNs = other.maxLatencyNs;
+    }
+
+    double meanLatencyUs() const { return applied ? totalLatencyNs / 1000.0 / applied : 0.0; }
+};
+
+#endif
@@ -0,0 +1,467 @@
+// leaderboard.cpp - 바이너리 랭킹 저장소 구현
+
+#include "leaderboard.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LEADERBOARD_MAGIC   "SNKB"
+#define LEADERBOARD_VERSION 1
+#define MERGE_CHUNK_RECORDS 4096
+
+// Best first: higher score, then the earlier entry
+static bool betterRecord(const LeaderboardRecord &a, const LeaderboardRecord &b) {
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.sequence < b.sequence;
+}
+
+// FNV-1a over everything but the checksum itself
+static std::uint32_t recordChecksum(const LeaderboardRecord &record) {
+    std::uint32_t hash = 2166136261u;
+    auto          mix  = [&hash](const void *data, size_t size) {
+        const unsigned char *bytes = (const unsigned char *)data;
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+    };
+    mix(&record.score, sizeof(record.score));
+    mix(&record.sequence, sizeof(record.sequence));
+    mix(record.name, sizeof(record.name));
+    return hash;
+}
+
+static LeaderboardRecord makeRecord(std::string_view name, int score, std::uint32_t sequence) {
+    LeaderboardRecord record;
+    memset(&record, 0, sizeof(record));
+    record.score    = score;
+    record.sequence = sequence;
+
+    // Truncate on a UTF-8 character boundary, keeping the terminating NUL
+    size_t length = std::min(name.size(), sizeof(record.name) - 1);
+    while (length > 0 && length < name.size() && ((unsigned char)name[length] & 0xc0) == 0x80)
+        --length;
+    memcpy(record.name, name.data(), length);
+    record.checksum = recordChecksum(record);
+    return record;
+}
+
+static bool writeAll(int fd, const void *data, size_t size) {
+    const char *bytes = (const char *)data;
+    while (size > 0) {
+        ssize_t n = write(fd, bytes, size);
+        if (n <= 0)
+            return false;
+        bytes += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool readAllAt(int fd, void *data, size_t size, off_t offset) {
+    char *bytes = (char *)data;
+    while (size > 0) {
+        ssize_t n = pread(fd, bytes, size, offset);
+        if (n <= 0)
+            return false;
+        bytes += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+// Makes a rename() in the directory of `path` durable.
+static void syncParentDirectory(const std::string &path) {
+    size_t      slash = path.find_last_of('/');
+    std::string dir   = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    int         fd    = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// Exclusive flock on the log for the lifetime of the object. Appending, merging and truncating
+// all happen under it, so no process cuts off or misses a record another one appended.
+struct LogLock {
+    int fd;
+    explicit LogLock(int logFd) : fd(logFd) {
+        while (fd >= 0 && flock(fd, LOCK_EX) != 0 && errno == EINTR) {
+        }
+    }
+    ~LogLock() {
+        if (fd >= 0)
+            flock(fd, LOCK_UN);
+    }
+};
+
+Leaderboard::Leaderboard(const std::string &basePath)
+    : datPath(basePath + ".dat"), logPath(basePath + ".log") {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEADERBOARD_MAGIC, 4);
+    header.version = LEADERBOARD_VERSION;
+}
+
+Leaderboard::~Leaderboard() {
+    unmapSorted();
+    if (datFd >= 0)
+        close(datFd);
+    if (logFd >= 0)
+        close(logFd);
+}
+
+static std::string_view recordName(const LeaderboardRecord &record) {
+    return std::string_view(record.name, strnlen(record.name, sizeof(record.name)));
+}
+
+void Leaderboard::mapSorted() {
+    unmapSorted();
+    size_t size = sizeof(header) + header.count * sizeof(LeaderboardRecord);
+    void  *data = datFd >= 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, datFd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED)
+        return; // readSorted() falls back to pread
+    madvise(data, size, MADV_RANDOM); // Binary searches and single pages, not scans
+    sorted     = (const LeaderboardRecord *)((const char *)data + sizeof(header));
+    mappedSize = size;
+}
+
+void Leaderboard::unmapSorted() {
+    if (sorted)
+        munmap((char *)sorted - sizeof(header), mappedSize);
+    sorted     = nullptr;
+    mappedSize = 0;
+}
+
+bool Leaderboard::open() {
+    if (logFd >= 0)
+        close(logFd);
+    // Fall back to read-only so a viewer still works without write access
+    logFd = ::open(logPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (logFd < 0)
+        logFd = ::open(logPath.c_str(), O_RDONLY);
+
+    LogLock lock(logFd);
+    if (!load())
+        return false;
+    if (datFd < 0 && log.empty() && access(LEGACY_RANKING_FILE, R_OK) == 0)
+        return importLegacy();
+    return true;
+}
+
+bool Leaderboard::load() {
+    // Reloading picks up whatever other processes have written since
+    unmapSorted();
+    if (datFd >= 0)
+        close(datFd);
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEADERBOARD_MAGIC, 4);
+    header.version = LEADERBOARD_VERSION;
+
+    datFd = ::open(datPath.c_str(), O_RDONLY);
+    if (datFd >= 0) {
+        struct stat st;
+        if (!readAllAt(datFd, &header, sizeof(header), 0) ||
+            memcmp(header.magic, LEADERBOARD_MAGIC, 4) != 0 ||
+            header.version != LEADERBOARD_VERSION || header.topCount > LEADERBOARD_TOP_K ||
+            fstat(datFd, &st) != 0 ||
+            (std::uint64_t)st.st_size < sizeof(header) + header.count * sizeof(LeaderboardRecord))
+            return false;
+        mapSorted();
+    }
+
+    // Keep every intact record; cut off a torn one left by a crash mid-append. Appends hold
+    // the lock too, so a torn record here is never one still being written.
+    off_t             offset = 0;
+    LeaderboardRecord record;
+    log.clear();
+    while (logFd >= 0 && readAllAt(logFd, &record, sizeof(record), offset)) {
+        if (record.checksum != recordChecksum(record))
+            break;
+        if (record.sequence >= header.nextSequence) // Older ones were merged before a crash
+            log.push_back(record);
+        offset += sizeof(record);
+    }
+    if (logFd >= 0 && ftruncate(logFd, offset) != 0) {
+        // Read-only log: the torn tail is simply ignored
+    }
+    std::sort(log.begin(), log.end(), betterRecord);
+    return true;
+}
+
+// One-time conversion of the old "name score" text file. Parsed straight out of a
+// read-only mapping so a history of millions of lines imports in one pass.
+bool Leaderboard::importLegacy() {
+    int         fd = ::open(LEGACY_RANKING_FILE, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void  *data = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    std::string_view text((const char *)data, size);
+    std::uint32_t    sequence = 0;
+    while (!text.empty()) {
+        size_t           newline = text.find('\n');
+        std::string_view line    = text.substr(0, newline);
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        size_t pos   = line.find_last_of(' ');
+        int    score = 0;
+        if (line.empty() || pos == std::string_view::npos)
+            continue;
+        std::from_chars(line.data() + pos + 1, line.data() + line.size(), score);
+        log.push_back(makeRecord(line.substr(0, pos), score, sequence++));
+    }
+    if (data)
+        munmap(data, size);
+    std::sort(log.begin(), log.end(), betterRecord);
+    return merge();
+}
+
+bool Leaderboard::readSorted(std::uint64_t index, LeaderboardRecord &record) const {
+    if (sorted) {
+        record = sorted[index];
+        return true;
+    }
+    return readAllAt(datFd, &record, sizeof(record),
+                     sizeof(header) + index * sizeof(LeaderboardRecord));
+}
+
+long long Leaderboard::sortedRankOf(int score) const {
+    // The first TOP_K records are cached in the header
+    std::uint64_t lo = 0, hi = header.count;
+    while (lo < hi && lo < header.topCount) {
+        if (header.top[lo].score < score)
+            return (long long)lo;
+        ++lo;
+    }
+    // Binary search for the first record scoring below `score`
+    LeaderboardRecord record;
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        if (!readSorted(mid, record))
+            return -1;
+        if (record.score >= score)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (long long)lo;
+}
+
+long long Leaderboard::insert(const std::string &name, int score) {
+    if (logFd < 0)
+        return -1;
+    // Sequence and rank come from the store as it is now, other processes' games included
+    LogLock lock(logFd);
+    if (!load())
+        return -1;
+
+    std::uint32_t sequence = header.nextSequence;
+    for (const LeaderboardRecord &r : log)
+        sequence = std::max(sequence, r.sequence + 1);
+
+    LeaderboardRecord record = makeRecord(name, score, sequence);
+    if (!writeAll(logFd, &record, sizeof(record)) || fdatasync(logFd) != 0)
+        return -1;
+
+    // Everything already stored that scores at least as much ranks ahead of this game
+    long long rank = sortedRankOf(score);
+    if (rank < 0)
+        return -1;
+    for (const LeaderboardRecord &r : log)
+        if (r.score >= score)
+            ++rank;
+
+    log.insert(std::upper_bound(log.begin(), log.end(), record, betterRecord), record);
+    // Let the log grow with the store so each merge is paid for by many inserts
+    std::uint64_t limit = std::max<std::uint64_t>(LEADERBOARD_LOG_LIMIT, header.count / 1024);
+    if (log.size() >= limit)
+        merge();
+    return rank + 1;
+}
+
+std::vector<LeaderboardEntry> Leaderboard::top(int k) const {
+    std::vector<LeaderboardEntry> entries;
+    k = std::min(k, LEADERBOARD_TOP_K);
+
+    unsigned i = 0;
+    size_t   j = 0;
+    while ((int)entries.size() < k && (i < header.topCount || j < log.size())) {
+        const LeaderboardRecord &next =
+            j >= log.size() || (i < header.topCount && betterRecord(header.top[i], log[j]))
+                ? header.top[i++]
+                : log[j++];
+        entries.push_back({std::string(next.name, strnlen(next.name, sizeof(next.name))),
+                           (int)next.score});
+    }
+    return entries;
+}
+
+void Leaderboard::splitAt(long long index, std::uint64_t &sortedPos, size_t &logPos) const {
+    // Smallest number of log records `b` such that log[b] doesn't come before the
+    // sorted record just ahead of the split; monotonic in b, so binary search it
+    std::uint64_t     n  = header.count;
+    size_t            lo = (std::uint64_t)index > n ? (size_t)(index - n) : 0;
+    size_t            hi = std::min<std::uint64_t>(index, log.size());
+    LeaderboardRecord record;
+    while (lo < hi) {
+        size_t        b = lo + (hi - lo) / 2;
+        std::uint64_t a = index - b;
+        if (a == 0 || (readSorted(a - 1, record) && betterRecord(record, log[b])))
+            hi = b;
+        else
+            lo = b + 1;
+    }
+    logPos    = lo;
+    sortedPos = index - lo;
+}
+
+void Leaderboard::page(long long first, int count, std::vector<LeaderboardRow> &rows) const {
+    rows.clear();
+    if (first < 0 || first >= size())
+        return;
+    count = (int)std::min<long long>(count, size() - first);
+
+    // Without the mapping the rows need somewhere to point at
+    if (!sorted) {
+        pageRecords.clear();
+        pageRecords.reserve(count);
+    }
+
+    std::uint64_t i;
+    size_t        j;
+    splitAt(first, i, j);
+    LeaderboardRecord record;
+    for (int k = 0; k < count; ++k) {
+        const LeaderboardRecord *next;
+        bool fromSorted = i < header.count && readSorted(i, record) &&
+                          (j >= log.size() || betterRecord(record, log[j]));
+        if (fromSorted && sorted) {
+            next = &sorted[i++];
+        } else if (fromSorted) {
+            pageRecords.push_back(record);
+            next = &pageRecords.back();
+            ++i;
+        } else if (j < log.size()) {
+            next = &log[j++];
+        } else {
+            break; // Unreadable sorted record
+        }
+        rows.push_back({first + k + 1, recordName(*next), (int)next->score});
+    }
+}
+
+long long Leaderboard::find(std::string_view name, long long from) const {
+    long long total = size();
+    if (total == 0)
+        return -1;
+    from = std::clamp<long long>(from, 0, total - 1);
+
+    std::uint64_t i;
+    size_t        j;
+    splitAt(from, i, j);
+    LeaderboardRecord record;
+    for (long long k = 0; k < total; ++k) {
+        if (from + k == total) { // Wrap around to the top
+            i = 0;
+            j = 0;
+        }
+        bool fromSorted = i < header.count && readSorted(i, record) &&
+                          (j >= log.size() || betterRecord(record, log[j]));
+        if (!fromSorted && j >= log.size())
+            return -1; // Unreadable sorted record
+        const LeaderboardRecord &next = fromSorted ? record : log[j];
+        if (fromSorted)
+            ++i;
+        else
+            ++j;
+        if (recordName(next) == name)
+            return (from + k) % total;
+    }
+    return -1;
+}
+
+bool Leaderboard::compact() {
+    LogLock lock(logFd);
+    return load() && merge();
+}
+
+bool Leaderboard::merge() {
+    // Only the lock holder gets here, so the temp file is never shared
+    std::string tmpPath = datPath + ".tmp";
+    int         fd      = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    LeaderboardHeader merged = header;
+    merged.count             = header.count + log.size();
+    merged.topCount          = 0;
+    for (const LeaderboardRecord &r : log)
+        merged.nextSequence = std::max(merged.nextSequence, r.sequence + 1);
+
+    // Stream the sorted run through a chunk buffer, merging the log in as we go
+    bool ok = lseek(fd, sizeof(merged), SEEK_SET) == (off_t)sizeof(merged);
+    std::vector<LeaderboardRecord> in(MERGE_CHUNK_RECORDS), out;
+    out.reserve(MERGE_CHUNK_RECORDS);
+    std::uint64_t loaded = 0, inPos = 0, inSize = 0;
+    size_t        j      = 0;
+    while (ok && (inPos < inSize || loaded < header.count || j < log.size())) {
+        if (inPos == inSize && loaded < header.count) {
+            inSize = std::min<std::uint64_t>(MERGE_CHUNK_RECORDS, header.count - loaded);
+            ok     = readAllAt(datFd, in.data(), inSize * sizeof(LeaderboardRecord),
+                               sizeof(header) + loaded * sizeof(LeaderboardRecord));
+            loaded += inSize;
+            inPos = 0;
+            continue;
+        }
+        const LeaderboardRecord &next =
+            j >= log.size() || (inPos < inSize && betterRecord(in[inPos], log[j])) ? in[inPos++]
+                                                                                    : log[j++];
+        if (merged.topCount < LEADERBOARD_TOP_K)
+            merged.top[merged.topCount++] = next;
+        out.push_back(next);
+        if (out.size() == MERGE_CHUNK_RECORDS) {
+            ok = writeAll(fd, out.data(), out.size() * sizeof(LeaderboardRecord));
+            out.clear();
+        }
+    }
+    ok = ok && writeAll(fd, out.data(), out.size() * sizeof(LeaderboardRecord));
+    ok = ok && pwrite(fd, &merged, sizeof(merged), 0) == (ssize_t)sizeof(merged);
+    ok = ok && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmpPath.c_str(), datPath.c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    syncParentDirectory(datPath);
+
+    // The log entries are now in the sorted run; nextSequence tells open() to skip them
+    // if we crash before the truncate below.
+    unmapSorted();
+    if (datFd >= 0)
+        close(datFd);
+    datFd  = ::open(datPath.c_str(), O_RDONLY);
+    header = merged;
+    log.clear();
+    mapSorted();
+    if (logFd >= 0 && ftruncate(logFd, 0) == 0)
+        fdatasync(logFd);
+    return datFd >= 0;
+}
@@ -0,0 +1,113 @@
+// leaderboard.h - 색인된 바이너리 랭킹 저장소
+// ranking.dat : 헤더(상위 K개 캐시 포함) + 점수 내림차순으로 정렬된 고정 크기 레코드.
+//               이 파일은 임시 파일에 다 쓴 뒤 rename 으로만 교체되므로 중간에 죽어도 깨지지 않는다.
+// ranking.log : 마지막 병합 이후 추가된 레코드를 뒤에 이어 붙이는 로그. 레코드마다 체크섬이 있어
+//               쓰다 만 꼬리는 열 때 잘라 낸다. LEADERBOARD_LOG_LIMIT 개 (또는 전체의 1/1024)가
+//               쌓이면 .dat 로 병합한다.
+// 여러 프로세스: 로그 추가, 병합, rename, 로그 비우기는 모두 ranking.log 에 flock(LOCK_EX) 을
+//               잡고 하고, 잡은 뒤 헤더와 로그를 다시 읽으므로 남이 추가한 기록을 잃지 않는다.
+//
+// 삽입: 로그에 레코드 하나 추가 + 이진 탐색으로 순위 계산 (O(log n)), 병합 비용은 분할 상환.
+// 상위 20개: 헤더 캐시와 (크기가 제한된) 로그만 보면 되므로 전체 크기와 무관하다.
+// 페이지 보기: ranking.dat 를 mmap 해 두고 정렬된 레코드와 로그를 병합한 순서에서 원하는 위치를
+//              이진 탐색으로 찾는다. 이름은 매핑된 레코드를 가리키는 string_view 라 복사가 없다.
+// 정수는 호스트 바이트 순서(리틀 엔디언)로 저장한다.
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define LEADERBOARD_BASE      "ranking"     // ranking.dat / ranking.log
+#define LEGACY_RANKING_FILE   "ranking.txt" // Imported once when no store exists yet
+#define LEADERBOARD_TOP_K     20
+#define LEADERBOARD_LOG_LIMIT 256
+#define LEADERBOARD_NAME_SIZE 52
+
+struct LeaderboardRecord {
+    std::int32_t  score;
+    std::uint32_t sequence; // Insertion order; the earlier entry wins a tie
+    std::uint32_t checksum;
+    char          name[LEADERBOARD_NAME_SIZE]; // UTF-8, NUL padded
+};
+static_assert(sizeof(LeaderboardRecord) == 64, "records are 64 bytes on disk");
+
+struct LeaderboardHeader {
+    char              magic[4]; // "SNKB"
+    std::uint32_t     version;
+    std::uint64_t     count;          // Sorted records following the header
+    std::uint32_t     nextSequence;   // Every sequence below this is in the sorted run
+    std::uint32_t     topCount;       // Valid entries in top[]
+    std::uint8_t      reserved[40];
+    LeaderboardRecord top[LEADERBOARD_TOP_K]; // Copy of the first sorted records
+};
+
+struct LeaderboardEntry {
+    std::string name;
+    int         score;
+};
+
+// One line of a ranking page. `name` points into the store and stays valid until it is
+// reopened, inserted into, compacted or destroyed.
+struct LeaderboardRow {
+    long long        rank; // 1-based
+    std::string_view name;
+    int              score;
+};
+
+struct Leaderboard {
+    explicit Leaderboard(const std::string &basePath = LEADERBOARD_BASE);
+    ~Leaderboard();
+
+    // Loads the header and the log, importing the legacy text ranking on first use.
+    // Returns false if the store exists but can't be read.
+    bool open();
+
+    // Records a game. Returns its 1-based rank, or -1 if it couldn't be written.
+    long long insert(const std::string &name, int score);
+
+    // Best `k` entries (k <= LEADERBOARD_TOP_K), best first.
+    std::vector<LeaderboardEntry> top(int k = LEADERBOARD_TOP_K) const;
+
+    // Total number of entries.
+    long long size() const { return (long long)header.count + (long long)log.size(); }
+
+    // Fills `rows` with up to `count` entries starting at 0-based position `first`.
+    // Reuses the vector's storage and copies no names.
+    void page(long long first, int count, std::vector<LeaderboardRow> &rows) const;
+
+    // Position of the first entry at or after `from` named exactly `name`, wrapping
+    // around to the top. Returns -1 if there is none.
+    long long find(std::string_view name, long long from) const;
+
+    // Merges the log into the sorted file (temp file + rename) and empties the log.
+    bool compact();
+
+  private:
+    // Rereads the header and the log; open(), insert() and compact() call it holding the
+    // log's flock, and merge() must be called holding it too.
+    bool      load();
+    bool      merge();
+    bool      importLegacy();
+    long long sortedRankOf(int score) const; // Sorted records scoring >= score
+    bool      readSorted(std::uint64_t index, LeaderboardRecord &record) const;
+    void      mapSorted();
+    void      unmapSorted();
+    // Splits merged position `index` into how many sorted and log records precede it.
+    void splitAt(long long index, std::uint64_t &sortedPos, size_t &logPos) const;
+
+    std::string                    datPath, logPath;
+    int                            datFd = -1;
+    int                            logFd = -1;
+    LeaderboardHeader              header;
+    std::vector<LeaderboardRecord> log;                  // Unmerged records, kept sorted best first
+    const LeaderboardRecord       *sorted     = nullptr; // Mapped sorted run, if mmap worked
+    size_t                         mappedSize = 0;
+
+    mutable std::vector<LeaderboardRecord> pageRecords; // Backs page() rows when not mapped
+};
+
+#endif
@@ -0,0 +1,246 @@
+// map_generator.cpp - 스테이지 지형 생성기 구현
+
+#include "map_generator.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#define ROOM_SPAN 7          // Room walls every ROOM_SPAN cells, so rooms are 6x6 inside
+#define MAZE_LOOP_PERCENT 12 // Maze walls knocked through afterwards, so the snake can turn back
+
+static const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4] = {0, 0, -1, 1};
+
+static bool isInner(const GameState &state, int y, int x) {
+    return y > 0 && y < state.height - 1 && x > 0 && x < state.width - 1;
+}
+
+// Border walls (corners immune) around `inner`.
+static void buildFrame(GameState &state, int inner) {
+    const int H   = state.height;
+    const int W   = state.width;
+    auto     &map = state.map;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            if ((y == 0 || y == H - 1) && (x == 0 || x == W - 1))
+                map[y * W + x] = CELL_IMMUNE_WALL;
+            else if (y == 0 || y == H - 1 || x == 0 || x == W - 1)
+                map[y * W + x] = CELL_WALL;
+            else
+                map[y * W + x] = inner;
+        }
+    }
+}
+
+// Turns each empty inner cell into a wall with probability `percent`.
+static void scatterWalls(GameState &state, double percent) {
+    const int W   = state.width;
+    auto     &map = state.map;
+    for (int y = 1; y < state.height - 1; ++y) {
+        for (int x = 1; x < W - 1; ++x) {
+            if (map[y * W + x] == CELL_EMPTY &&
+                (state.rng() / (double)state.rng.max()) * 100.0 < percent) {
+                map[y * W + x] = CELL_WALL;
+            }
+        }
+    }
+}
+
+// Depth-first maze over the cells with odd coordinates, then a few extra openings.
+static void carveMaze(GameState &state) {
+    const int W   = state.width;
+    auto     &map = state.map;
+    buildFrame(state, CELL_WALL);
+
+    std::vector<int> stack;
+    map[1 * W + 1] = CELL_EMPTY;
+    stack.push_back(1 * W + 1);
+    while (!stack.empty()) {
+        int cell = stack.back();
+        int y = cell / W, x = cell % W;
+        int options[4], count = 0;
+        for (int d = 0; d < 4; ++d) {
+            int ny = y + 2 * dy[d], nx = x + 2 * dx[d];
+            if (isInner(state, ny, nx) && map[ny * W + nx] == CELL_WALL)
+                options[count++] = d;
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int d    = options[state.rng.below(count)];
+        int next = (y + 2 * dy[d]) * W + x + 2 * dx[d];
+        map[(y + dy[d]) * W + x + dx[d]] = CELL_EMPTY; // The wall in between
+        map[next]                        = CELL_EMPTY;
+        stack.push_back(next);
+    }
+
+    // Walls between two passages (one odd and one even coordinate)
+    for (int y = 1; y < state.height - 1; ++y) {
+        for (int x = 1; x < W - 1; ++x) {
+            if (map[y * W + x] == CELL_WALL && (y % 2) != (x % 2) &&
+                state.rng.below(100) < MAZE_LOOP_PERCENT)
+                map[y * W + x] = CELL_EMPTY;
+        }
+    }
+}
+
+// One door somewhere in the wall between cells `from` and `to` (exclusive) of a wall line.
+static void openDoor(GameState &state, bool row, int line, int from, int to) {
+    if (to - from < 2)
+        return;
+    int at = from + 1 + (int)state.rng.below(to - from - 1);
+    state.map[row ? line * state.width + at : at * state.width + line] = CELL_EMPTY;
+}
+
+// A grid of rooms with a door in every wall between neighbours, scattered inside.
+static void buildRooms(GameState &state, double percent) {
+    const int H   = state.height;
+    const int W   = state.width;
+    auto     &map = state.map;
+    buildFrame(state, CELL_EMPTY);
+    for (int y = ROOM_SPAN; y < H - 1; y += ROOM_SPAN)
+        for (int x = 1; x < W - 1; ++x)
+            map[y * W + x] = CELL_WALL;
+    for (int x = ROOM_SPAN; x < W - 1; x += ROOM_SPAN)
+        for (int y = 1; y < H - 1; ++y)
+            map[y * W + x] = CELL_WALL;
+
+    for (int y = ROOM_SPAN; y < H - 1; y += ROOM_SPAN)
+        for (int x = 0; x < W - 1; x += ROOM_SPAN)
+            openDoor(state, true, y, x, std::min(x + ROOM_SPAN, W - 1));
+    for (int x = ROOM_SPAN; x < W - 1; x += ROOM_SPAN)
+        for (int y = 0; y < H - 1; y += ROOM_SPAN)
+            openDoor(state, false, x, y, std::min(y + ROOM_SPAN, H - 1));
+    scatterWalls(state, percent);
+}
+
+// The snake's three cells and the one ahead of it.
+static void openStart(GameState &state) {
+    int y = state.height / 2;
+    for (int x = state.width / 2 - 2; x <= state.width / 2 + 1; ++x)
+        if (isInner(state, y, x))
+            state.map[y * state.width + x] = CELL_EMPTY;
+}
+
+// 0-1 BFS from the start over inner cells: an empty cell costs nothing to enter, a wall one.
+// Empty cells at cost 0 are the part the snake can reach; `parent` leads back towards it.
+// Returns how many empty cells are sealed off.
+static int measureSealed(const GameState &state, std::vector<int> &cost,
+                         std::vector<int> &parent) {
+    const int W     = state.width;
+    int       area  = state.height * W;
+    int       start = (state.height / 2) * W + state.width / 2;
+    cost.assign(area, -1);
+    parent.assign(area, -1);
+
+    std::deque<int> queue;
+    cost[start] = 0;
+    queue.push_back(start);
+    while (!queue.empty()) {
+        int cell = queue.front();
+        queue.pop_front();
+        int y = cell / W, x = cell % W;
+        for (int d = 0; d < 4; ++d) {
+            int ny = y + dy[d], nx = x + dx[d];
+            if (!isInner(state, ny, nx))
+                continue;
+            int  next = ny * W + nx;
+            bool wall = state.map[next] != CELL_EMPTY;
+            int  c    = cost[cell] + (wall ? 1 : 0);
+            if (cost[next] >= 0 && cost[next] <= c)
+                continue;
+            cost[next]   = c;
+            parent[next] = cell;
+            if (wall)
+                queue.push_back(next);
+            else
+                queue.push_front(next);
+        }
+    }
+
+    int sealed = 0;
+    for (int i = 0; i < area; ++i)
+        if (state.map[i] == CELL_EMPTY && cost[i] != 0)
+            sealed++;
+    return sealed;
+}
+
+// Joins every sealed pocket to the reachable part through the fewest walls. Each pocket is
+// flooded once it is joined, so the walk and the floods visit every cell a bounded number
+// of times. Returns the number of walls removed.
+static int joinPockets(GameState &state, const std::vector<int> &cost,
+                       const std::vector<int> &parent) {
+    const int W    = state.width;
+    int       area = state.height * W;
+    auto     &map  = state.map;
+
+    std::vector<std::uint8_t> joined(area, 0);
+    for (int i = 0; i < area; ++i)
+        joined[i] = map[i] == CELL_EMPTY && cost[i] == 0;
+
+    int              carved = 0;
+    std::vector<int> flood;
+    for (int i = 0; i < area; ++i) {
+        if (map[i] != CELL_EMPTY || joined[i])
+            continue;
+        // The path is open now; flooding from all of it also takes in pockets it crossed
+        flood.clear();
+        for (int cell = i; cell >= 0 && !joined[cell]; cell = parent[cell]) {
+            if (map[cell] != CELL_EMPTY) {
+                map[cell] = CELL_EMPTY;
+                carved++;
+            }
+            joined[cell] = 1;
+            flood.push_back(cell);
+        }
+        while (!flood.empty()) {
+            int cell = flood.back();
+            flood.pop_back();
+            int y = cell / W, x = cell % W;
+            for (int d = 0; d < 4; ++d) {
+                int next = (y + dy[d]) * W + x + dx[d];
+                if (map[next] == CELL_EMPTY && !joined[next]) {
+                    joined[next] = 1;
+                    flood.push_back(next);
+                }
+            }
+        }
+    }
+    return carved;
+}
+
+LayoutReport generateLayout(GameState &state, int stage) {
+    const GameRules &rules = *state.rules;
+    LayoutReport     report;
+    std::vector<int> cost, parent;
+    for (;;) {
+        report.attempts++;
+        switch (rules.layoutPerStage[stage]) {
+        case LAYOUT_MAZE:
+            carveMaze(state);
+            break;
+        case LAYOUT_ROOMS:
+            buildRooms(state, rules.innerWallProbability[stage]);
+            break;
+        default:
+            buildFrame(state, CELL_EMPTY);
+            scatterWalls(state, rules.innerWallProbability[stage]);
+            break;
+        }
+        openStart(state);
+
+        int sealed = measureSealed(state, cost, parent);
+        if (sealed == 0)
+            return report;
+
+        int open = 0;
+        for (std::uint8_t cell : state.map)
+            open += cell == CELL_EMPTY;
+        if (sealed * 100 <= open * LAYOUT_MAX_SEALED_PERCENT || report.attempts == LAYOUT_ATTEMPTS)
+            break;
+    }
+    report.carved = joinPockets(state, cost, parent);
+    return report;
+}
@@ -0,0 +1,27 @@
+// map_generator.h - 스테이지 지형 생성기
+// 테두리 벽을 두르고 GameRules::layoutPerStage 에 따라 안쪽 벽을 만든다.
+//   LAYOUT_SCATTER : 칸마다 innerWallProbability(%) 확률로 벽 (원래 방식)
+//   LAYOUT_MAZE    : 홀수 좌표 칸을 잇는 DFS 미로에 벽 몇 개를 더 뚫어 고리를 만든 것
+//   LAYOUT_ROOMS   : ROOM_SPAN 간격의 벽으로 나눈 방마다 벽면에 문 하나, 안쪽은 scatter
+// 만든 뒤 시작 위치에서 flood fill 해서 모든 빈 칸이 한 덩어리인지 확인한다. 막힌 칸이 많으면
+// 최대 LAYOUT_ATTEMPTS 번까지 다시 만들고, 마지막에는 0-1 BFS 로 가장 적은 벽을 뚫어 잇는다.
+// 모든 단계가 보드 넓이에 선형이라 한 번 만드는 시간의 상한이 정해져 있다.
+
+#ifndef MAP_GENERATOR_H
+#define MAP_GENERATOR_H
+
+#include "snake_engine.h"
+
+#define LAYOUT_ATTEMPTS 4           // Layouts tried before repairing the last one
+#define LAYOUT_MAX_SEALED_PERCENT 2 // Sealed-off share of open cells still worth repairing
+
+struct LayoutReport {
+    int attempts = 0; // Layouts generated, 1..LAYOUT_ATTEMPTS
+    int carved   = 0; // Walls removed to join sealed pockets to the rest
+};
+
+// Writes walls and empty cells for `stage` into state.map (nothing else is touched). The row
+// the snake starts on is kept open around it, and every empty cell is reachable from there.
+LayoutReport generateLayout(GameState &state, int stage);
+
+#endif
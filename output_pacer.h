@@ -0,0 +1,159 @@
+// output_pacer.h - 느린 터미널 연결에 맞춰 화면 출력량을 줄이는 페이서
+// 그린 프레임 뒤에 커서 위치 질의(DSR, ESC [ 6 n)를 붙여 보낸다. 터미널은 앞의 바이트를 모두
+// 처리한 뒤에야 답하므로, 답이 오면 그 질의까지 보낸 바이트가 화면에 닿았다는 뜻이다. 보냈지만
+// 아직 확인되지 않은 바이트가 밀린 양이고(ssh 와 커널 버퍼 안에 있는 것까지 포함), 답 사이에
+// 확인된 바이트로 연결의 처리량을, 가장 짧은 왕복 시간으로 원래 지연을 잰다. 답하지 않는
+// 터미널에서는 출력 큐(TIOCOUTQ)와 아직 못 쓴 바이트만 본다.
+// 다음 틱까지 다 빠지지 못할 만큼 밀려 있으면 그 프레임은 건너뛴다. 엔진의 damage list 가
+// 그대로 남아 있으므로 다음에 그리는 프레임이 밀린 변화를 한꺼번에 그린다.
+// 건너뛰기가 잦으면 칸 하나에 3 바이트인 ASCII 글리프로 바꾸고, 한동안 건너뛰지 않으면
+// 되돌린다. 되돌린 뒤 다시 밀리면 되돌리기까지 기다리는 시간을 두 배로 늘린다.
+
+#ifndef OUTPUT_PACER_H
+#define OUTPUT_PACER_H
+
+#include <sys/ioctl.h>
+
+#define PACER_PROBE "\x1b[6n"              // DSR; the answer is ESC [ row ; col R
+#define PACER_PROBE_LOST_NS 10000000000LL  // An answer this late is given up on
+#define PACER_SETTLE_NS 2000000000LL       // Wait for the last answer when the game stops
+#define PACER_MIN_BACKLOG 1024             // Unconfirmed bytes always tolerated
+#define PACER_HUD_INTERVAL_NS 250000000LL  // HUD redraw period while pacing
+#define PACER_WINDOW_NS 1000000000LL       // Dropped frames are counted per window
+#define PACER_COMPACT_DROP_PERCENT 25      // Dropped share of a window that goes compact
+#define PACER_RECOVER_NS 5000000000LL      // Time without drops before full glyphs return
+#define PACER_MAX_RECOVER_NS 80000000000LL // Longest wait after repeated fallbacks
+
+// Bytes waiting in the terminal's output queue; 0 when that can't be told.
+inline int terminalBacklog(int fd) {
+#ifdef TIOCOUTQ
+    int queued = 0;
+    if (ioctl(fd, TIOCOUTQ, &queued) == 0)
+        return queued;
+#else
+    (void)fd;
+#endif
+    return 0;
+}
+
+struct OutputPacer {
+    bool      compact   = false; // ASCII glyphs in use
+    bool      answering = false; // The terminal has answered a probe
+    double    rate      = 0;     // Measured throughput (bytes/s)
+    long long baseRttNs = 0;     // Shortest probe round trip
+    long long backlog   = 0;     // Unconfirmed bytes at the last frameDue()
+    long long drawn     = 0;     // Frames drawn
+    long long dropped   = 0;     // Frames skipped because of the backlog
+    long long fallbacks = 0;     // Switches to compact glyphs
+    long long recoverNs = PACER_RECOVER_NS;
+
+  private:
+    long long sent        = 0; // Bytes handed to the terminal
+    long long probeBytes  = 0; // `sent` when the outstanding probe went out
+    long long probeNs     = 0; // When it went out; 0 when none is outstanding
+    long long ackedBytes  = 0; // `sent` at the last answered probe
+    long long ackNs       = 0; // When that answer came
+    long long localQueued = 0; // Local queue at the last frameDue()
+    long long localSent   = 0; // `sent` then
+    long long localNs     = 0;
+    long long dropNs      = 0; // Last dropped frame
+    long long windowNs    = 0; // Start of the current drop window
+    int       windowDrawn = 0, windowDropped = 0;
+    long long hudNs       = 0; // Last HUD redraw
+
+    // Keeps the best recent throughput: a link that was idle part of the time reports
+    // less than it can carry, so lower samples only pull the estimate down slowly.
+    void addRateSample(double sample) {
+        rate = sample > rate ? sample : rate * 0.95 + sample * 0.05;
+    }
+
+  public:
+    // Whether to draw the frame due at `nowNs`, with `queued` bytes still waiting locally
+    // and `tickNs` until the next frame. Also decides the glyph set; the caller redraws
+    // everything when `compact` changes.
+    bool frameDue(long long nowNs, long long queued, long long tickNs) {
+        if (!answering) {
+            // Whatever left the local queue since the last frame went out at the link's pace
+            long long drained = localQueued + (sent - localSent) - queued;
+            if (localQueued > 0 && nowNs > localNs && drained >= 0)
+                addRateSample(drained * 1e9 / (nowNs - localNs));
+        }
+        localQueued = queued;
+        localSent   = sent;
+        localNs     = nowNs;
+        if (probeNs && nowNs - probeNs >= PACER_PROBE_LOST_NS)
+            forgetProbe();
+
+        backlog = answering && sent - ackedBytes > queued ? sent - ackedBytes : queued;
+        // Bytes in flight over an idle link plus one tick of output are fine
+        long long budget = (long long)(rate * (tickNs + baseRttNs) / 1e9);
+        bool      draw   = backlog <= (budget > PACER_MIN_BACKLOG ? budget : PACER_MIN_BACKLOG);
+        if (draw) {
+            drawn++;
+            windowDrawn++;
+        } else {
+            dropped++;
+            windowDropped++;
+            dropNs = nowNs;
+        }
+
+        if (nowNs - windowNs >= PACER_WINDOW_NS) {
+            int frames = windowDrawn + windowDropped;
+            if (!compact && windowDropped * 100 >= frames * PACER_COMPACT_DROP_PERCENT) {
+                compact = true;
+                fallbacks++;
+                if (fallbacks > 1 && recoverNs < PACER_MAX_RECOVER_NS)
+                    recoverNs *= 2;
+            }
+            windowNs    = nowNs;
+            windowDrawn = windowDropped = 0;
+        }
+        if (compact && nowNs - dropNs >= recoverNs)
+            compact = false;
+        return draw;
+    }
+
+    // `bytes` were handed to the terminal, probe included.
+    void wrote(long long bytes) { sent += bytes; }
+
+    // True when no probe is outstanding. The caller appends PACER_PROBE to the frame,
+    // then calls wrote() and probeSent().
+    bool probeDue() const { return probeNs == 0; }
+    bool probePending() const { return probeNs != 0; }
+    void probeSent(long long nowNs) {
+        probeBytes = sent;
+        probeNs    = nowNs;
+    }
+
+    // The terminal answered the outstanding probe at `nowNs`.
+    void probeAnswered(long long nowNs) {
+        if (!probeNs)
+            return; // Late answer to a forgotten probe
+        long long rtt = nowNs - probeNs;
+        if (baseRttNs == 0 || rtt < baseRttNs)
+            baseRttNs = rtt;
+        if (ackNs && nowNs > ackNs && probeBytes > ackedBytes)
+            addRateSample((probeBytes - ackedBytes) * 1e9 / (nowNs - ackNs));
+        ackedBytes = probeBytes;
+        ackNs      = nowNs;
+        probeNs    = 0;
+        answering  = true;
+    }
+
+    // For when the answer was thrown away (keys discarded): trusts everything sent so far.
+    void forgetProbe() {
+        ackedBytes = sent;
+        probeNs    = 0;
+        ackNs      = 0;
+    }
+
+    // True at most once per PACER_HUD_INTERVAL_NS.
+    bool hudDue(long long nowNs) {
+        if (nowNs - hudNs < PACER_HUD_INTERVAL_NS)
+            return false;
+        hudNs = nowNs;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,196 @@
+// replay.cpp - 리플레이 파일 입출력과 재생
+// 파일 구성 (정수는 모두 리틀 엔디언):
+//   "SNKR" | version u8 | height u16 | width u16 | seed u32 | ticks varint
+//   | finalScore i32 | gameOverReason u8 | stage u8 | won u8
+//   | startSize varint | 이어 한 판이면 시작 스냅샷 (startSize 바이트, 아니면 0)
+//   | inputCount varint | inputCount x varint((tick - previousTick) << 2 | dir)
+
+#include "replay.h"
+
+#include "snapshot.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+void beginReplay(Replay &replay, const GameState &state, unsigned seed) {
+    replay        = Replay();
+    replay.seed   = seed;
+    replay.height = state.height;
+    replay.width  = state.width;
+}
+
+void beginResumedReplay(Replay &replay, const GameState &state) {
+    replay        = Replay();
+    replay.height = state.height;
+    replay.width  = state.width;
+    encodeSnapshot(state, replay.start);
+}
+
+void recordTick(Replay &replay, int input) {
+    if (input >= UP && input <= RIGHT)
+        replay.inputs.push_back({replay.ticks, input});
+    replay.ticks++;
+}
+
+void finishReplay(Replay &replay, const GameState &state) {
+    replay.finalScore     = finalScore(state);
+    replay.gameOverReason = state.gameOverReason;
+    replay.stage          = state.currentStage;
+    replay.won            = state.gameWon;
+}
+
+// --- Encoding helpers ---
+
+static void putByte(std::vector<std::uint8_t> &out, unsigned value) {
+    out.push_back((std::uint8_t)value);
+}
+
+static void putU16(std::vector<std::uint8_t> &out, unsigned value) {
+    putByte(out, value & 0xff);
+    putByte(out, (value >> 8) & 0xff);
+}
+
+static void putU32(std::vector<std::uint8_t> &out, std::uint32_t value) {
+    putU16(out, value & 0xffff);
+    putU16(out, value >> 16);
+}
+
+static void putVarint(std::vector<std::uint8_t> &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        putByte(out, (value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    putByte(out, (unsigned)value);
+}
+
+struct ReplayReader {
+    const std::uint8_t *data;
+    size_t              size;
+    size_t              pos = 0;
+    bool                ok  = true;
+
+    unsigned byte() {
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+    unsigned u16() {
+        unsigned low = byte();
+        return low | (byte() << 8);
+    }
+    std::uint32_t u32() {
+        std::uint32_t low = u16();
+        return low | ((std::uint32_t)u16() << 16);
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned b = byte();
+            value |= (std::uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+bool saveReplay(const Replay &replay, const char *path) {
+    std::vector<std::uint8_t> out;
+    out.reserve(32 + replay.start.size() + replay.inputs.size() * 2);
+    out.insert(out.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    putByte(out, REPLAY_VERSION);
+    putU16(out, replay.height);
+    putU16(out, replay.width);
+    putU32(out, replay.seed);
+    putVarint(out, replay.ticks);
+    putU32(out, (std::uint32_t)replay.finalScore);
+    putByte(out, replay.gameOverReason);
+    putByte(out, replay.stage);
+    putByte(out, replay.won);
+    putVarint(out, replay.start.size());
+    out.insert(out.end(), replay.start.begin(), replay.start.end());
+    putVarint(out, replay.inputs.size());
+
+    long long previous = 0;
+    for (const ReplayInput &input : replay.inputs) {
+        putVarint(out, ((std::uint64_t)(input.tick - previous) << 2) | input.dir);
+        previous = input.tick;
+    }
+
+    return replaceFile(path, out.data(), out.size());
+}
+
+bool loadReplay(Replay &replay, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return false;
+    std::vector<std::uint8_t> data;
+    std::uint8_t              chunk[4096];
+    size_t                    n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(file);
+
+    if (data.size() < 5 || memcmp(data.data(), REPLAY_MAGIC, 4) != 0 ||
+        data[4] != REPLAY_VERSION)
+        return false;
+
+    ReplayReader in{data.data(), data.size(), 5};
+    replay                = Replay();
+    replay.height         = in.u16();
+    replay.width          = in.u16();
+    replay.seed           = in.u32();
+    replay.ticks          = (long long)in.varint();
+    replay.finalScore     = (int)in.u32();
+    replay.gameOverReason = in.byte();
+    replay.stage          = in.byte();
+    replay.won            = in.byte() != 0;
+
+    std::uint64_t startSize = in.varint();
+    if (!in.ok || startSize > data.size() - in.pos)
+        return false;
+    replay.start.assign(data.data() + in.pos, data.data() + in.pos + startSize);
+    in.pos += startSize;
+
+    std::uint64_t count = in.varint();
+    if (!in.ok || count > data.size())
+        return false;
+    replay.inputs.reserve(count);
+    long long tick = 0;
+    for (std::uint64_t i = 0; i < count && in.ok; ++i) {
+        std::uint64_t packed = in.varint();
+        tick += (long long)(packed >> 2);
+        replay.inputs.push_back({tick, (int)(packed & 3)});
+    }
+    return in.ok && replay.height >= MIN_BOARD_SIZE && replay.height <= MAX_BOARD_SIZE &&
+           replay.width >= MIN_BOARD_SIZE && replay.width <= MAX_BOARD_SIZE;
+}
+
+bool playReplay(const Replay &replay, GameState &state) {
+    if (replay.start.empty())
+        initGame(state, replay.seed, replay.height, replay.width);
+    else if (!decodeSnapshot(state, replay.start.data(), replay.start.size()))
+        return false;
+
+    size_t next = 0;
+    for (long long tick = 0; tick < replay.ticks && !state.gameOver; ++tick) {
+        int input = NO_INPUT;
+        if (next < replay.inputs.size() && replay.inputs[next].tick == tick)
+            input = replay.inputs[next++].dir;
+        step(state, input);
+    }
+
+    // A quit isn't a rule outcome; the recorder marks it after the last tick
+    if (replay.gameOverReason == 7 && !state.gameOver) {
+        state.gameOver       = true;
+        state.gameOverReason = 7;
+    }
+    return finalScore(state) == replay.finalScore &&
+           state.gameOverReason == replay.gameOverReason &&
+           state.currentStage == replay.stage && state.gameWon == replay.won;
+}
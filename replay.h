@@ -0,0 +1,57 @@
+// replay.h - 리플레이 기록/재생
+// 게임은 시드와 틱마다의 방향 입력만으로 완전히 결정되므로, 리플레이 파일에는
+// 보드 크기, 시드, 입력이 있었던 틱과 방향, 그리고 검증용 최종 결과만 저장한다.
+// 입력 하나는 (이전 입력과의 틱 간격 << 2 | 방향)을 가변 길이 정수로 적어 보통 1~2바이트다.
+// 스냅샷(snapshot.h)에서 이어 한 판은 시드 대신 그 스냅샷에서 시작한다.
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "snake_engine.h"
+
+#include <cstdint>
+#include <vector>
+
+#define REPLAY_MAGIC   "SNKR"
+#define REPLAY_VERSION 5 // 2: maps from generateLayout(), 3: gates from gateCandidates,
+                         // 4: games resumed from a snapshot, 5: spawns picked by rank
+
+struct ReplayInput {
+    long long tick; // 0-based index of the step() call
+    int       dir;
+};
+
+struct Replay {
+    unsigned  seed   = 0;
+    int       height = DEFAULT_HEIGHT;
+    int       width  = DEFAULT_WIDTH;
+    long long ticks  = 0; // step() calls made in the game
+
+    std::vector<std::uint8_t> start; // Snapshot the game resumed from; empty if initGame() began it
+
+    std::vector<ReplayInput> inputs; // Only ticks that had a direction key, in order
+
+    // Outcome of the recorded game, checked on playback
+    int  finalScore     = 0;
+    int  gameOverReason = 0;
+    int  stage          = 0;
+    bool won            = false;
+};
+
+// Starts a recording for a game that initGame() just set up with `seed`.
+void beginReplay(Replay &replay, const GameState &state, unsigned seed);
+// Starts a recording for a game that carries on from `state`, e.g. one loadSnapshot() restored.
+void beginResumedReplay(Replay &replay, const GameState &state);
+// Call once per step(), with the input passed to it.
+void recordTick(Replay &replay, int input);
+// Stores the final score and reason.
+void finishReplay(Replay &replay, const GameState &state);
+
+bool saveReplay(const Replay &replay, const char *path);
+bool loadReplay(Replay &replay, const char *path);
+
+// Re-simulates the replay from scratch (or from its snapshot) into `state`. Returns true if the outcome
+// matches the recorded one.
+bool playReplay(const Replay &replay, GameState &state);
+
+#endif
@@ -0,0 +1,316 @@
+// shared_leaderboard.cpp - 공유 메모리 랭킹 구현
+
+#include "shared_leaderboard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SHARED_MAGIC   "SNKS"
+#define SHARED_VERSION 1
+#define RECORD_MASK    (SHARED_RECORD_CAPACITY - 1)
+
+#define STALLED_RECORD_TIMEOUT_MS 5000
+
+static_assert((SHARED_RECORD_CAPACITY & RECORD_MASK) == 0, "capacity must be a power of two");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "top-K slots must be lock-free to be shared between processes");
+
+// Higher score first, then the earlier game
+static std::uint64_t makeKey(int score, std::uint32_t sequence) {
+    return ((std::uint64_t)((std::uint32_t)score ^ 0x80000000u) << 32) | (std::uint32_t)~sequence;
+}
+static int keyScore(std::uint64_t key) {
+    return (int)((std::uint32_t)(key >> 32) ^ 0x80000000u);
+}
+static std::uint32_t keySequence(std::uint64_t key) { return ~(std::uint32_t)key; }
+
+static long long monotonicMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void sleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// Holds ranking.lock for the lifetime of the object; only the holder writes the store.
+struct StoreLock {
+    int fd;
+    StoreLock() : fd(::open(LEADERBOARD_LOCK_FILE, O_RDWR | O_CREAT, 0644)) {
+        if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    ~StoreLock() {
+        if (fd >= 0)
+            close(fd); // Releases the flock
+    }
+};
+
+SharedLeaderboard::~SharedLeaderboard() {
+    waitForPersist();
+    if (segment)
+        munmap(segment, sizeof(SharedLeaderboardSegment));
+}
+
+bool SharedLeaderboard::attach(const char *path) {
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    // Growing an existing file is harmless; every process asks for the same size
+    if (fstat(fd, &st) != 0 ||
+        ((size_t)st.st_size < sizeof(SharedLeaderboardSegment) &&
+         ftruncate(fd, sizeof(SharedLeaderboardSegment)) != 0)) {
+        close(fd);
+        return false;
+    }
+    void *memory =
+        mmap(nullptr, sizeof(SharedLeaderboardSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+    segment = (SharedLeaderboardSegment *)memory;
+
+    // The first process seeds the segment; the rest wait until it's ready
+    std::uint32_t expected = 0;
+    if (segment->state.compare_exchange_strong(expected, 1)) {
+        seed();
+        segment->state.store(2, std::memory_order_release);
+    } else {
+        for (int waited = 0; segment->state.load(std::memory_order_acquire) != 2; ++waited) {
+            if (waited == 2000) { // The seeding process died; take over
+                seed();
+                segment->state.store(2, std::memory_order_release);
+            }
+            sleepMs(1);
+        }
+    }
+
+    if (memcmp(segment->magic, SHARED_MAGIC, 4) != 0 || segment->version != SHARED_VERSION) {
+        munmap(segment, sizeof(SharedLeaderboardSegment));
+        segment = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Fills a fresh segment with the store's top entries and the saved high score.
+void SharedLeaderboard::seed() {
+    StoreLock   lock;
+    Leaderboard store;
+
+    std::vector<LeaderboardEntry> best;
+    if (store.open())
+        best = store.top(LEADERBOARD_TOP_K);
+
+    int           high = 0;
+    std::ifstream file(HIGHSCORE_FILE);
+    file >> high;
+
+    for (int i = 0; i < LEADERBOARD_TOP_K; ++i)
+        segment->top[i].store(0);
+    for (std::uint32_t i = 0; i < best.size(); ++i) {
+        SharedRecord &record = segment->records[i];
+        record.rank.store((int)i + 1);
+        record.score = best[i].score;
+        record.flags = SHARED_RECORD_SEEDED;
+        snprintf(record.name, sizeof(record.name), "%s", best[i].name.c_str());
+        record.ready.store(i + 1, std::memory_order_release);
+        segment->top[i].store(makeKey(best[i].score, i));
+    }
+    segment->nextSequence.store((std::uint32_t)best.size());
+    segment->persisted.store((std::uint32_t)best.size());
+    segment->storedEntries.store(store.size());
+    segment->stalledSequence.store(NO_SEQUENCE);
+    segment->highScore.store(std::max(high, best.empty() ? 0 : best[0].score));
+    segment->topVersion.fetch_add(1);
+    memcpy(segment->magic, SHARED_MAGIC, 4);
+    segment->version = SHARED_VERSION;
+}
+
+bool SharedLeaderboard::pinnedByTop(std::uint32_t sequence) const {
+    for (int i = 0; i < LEADERBOARD_TOP_K; ++i) {
+        std::uint64_t key = segment->top[i].load(std::memory_order_acquire);
+        if (key != 0 && keySequence(key) == sequence)
+            return true;
+    }
+    return false;
+}
+
+// Walks down the slots swapping `key` in wherever it beats the current value and carrying
+// the displaced value on. Slot values only ever grow, so the order holds without locks.
+void SharedLeaderboard::pushTop(std::uint64_t key) {
+    for (int i = 0; i < LEADERBOARD_TOP_K && key != 0; ++i) {
+        std::uint64_t current = segment->top[i].load(std::memory_order_acquire);
+        while (key > current && !segment->top[i].compare_exchange_weak(current, key)) {
+        }
+        if (key > current) {
+            key = current;
+            segment->topVersion.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+void SharedLeaderboard::offerHighScore(int score) {
+    int current = segment->highScore.load();
+    while (score > current && !segment->highScore.compare_exchange_weak(current, score)) {
+    }
+}
+
+std::uint32_t SharedLeaderboard::insert(const std::string &name, int score) {
+    offerHighScore(score);
+
+    // Claim a sequence whose ring slot is free to reuse
+    std::uint32_t sequence;
+    bool          triedPersist = false;
+    for (;;) {
+        sequence = segment->nextSequence.load(std::memory_order_acquire);
+        if (sequence - segment->persisted.load(std::memory_order_acquire) >=
+            SHARED_RECORD_CAPACITY) {
+            if (triedPersist || !persistNow()) // Ring full of unpersisted games: make room
+                return NO_SEQUENCE;
+            triedPersist = true;
+            continue;
+        }
+        if (!segment->nextSequence.compare_exchange_weak(sequence, sequence + 1))
+            continue;
+        if (sequence >= SHARED_RECORD_CAPACITY &&
+            pinnedByTop(sequence - SHARED_RECORD_CAPACITY)) {
+            segment->skipped[sequence & RECORD_MASK].store(sequence + 1,
+                                                           std::memory_order_release);
+            continue;
+        }
+        break;
+    }
+
+    // Readers check `ready` before and after copying, so clear it while rewriting
+    SharedRecord &record = segment->records[sequence & RECORD_MASK];
+    record.ready.store(0, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.rank.store(0);
+    record.score = score;
+    record.flags = 0;
+    size_t length = std::min(name.size(), sizeof(record.name) - 1);
+    while (length > 0 && length < name.size() && ((unsigned char)name[length] & 0xc0) == 0x80)
+        --length; // Keep whole UTF-8 characters
+    memcpy(record.name, name.data(), length);
+    record.name[length] = '\0';
+    record.ready.store(sequence + 1, std::memory_order_release);
+
+    pushTop(makeKey(score, sequence));
+    return sequence;
+}
+
+bool SharedLeaderboard::persistNow() {
+    StoreLock lock;
+    if (lock.fd < 0)
+        return false;
+    Leaderboard store;
+    if (!store.open())
+        return false;
+
+    bool          ok       = true;
+    std::uint32_t sequence = segment->persisted.load(std::memory_order_acquire);
+    std::uint32_t end      = segment->nextSequence.load(std::memory_order_acquire);
+    for (; sequence != end; ++sequence) {
+        if (segment->skipped[sequence & RECORD_MASK].load(std::memory_order_acquire) ==
+            sequence + 1)
+            continue;
+        SharedRecord &record = segment->records[sequence & RECORD_MASK];
+        if (record.ready.load(std::memory_order_acquire) != sequence + 1) {
+            // Still being written; the next persist picks it up. A writer that died
+            // mid-insert would block everyone behind it, so give up on it after a while.
+            long long now = monotonicMs();
+            if (segment->stalledSequence.load() != sequence) {
+                segment->stalledSequence.store(sequence);
+                segment->stalledSinceMs.store(now);
+                break;
+            }
+            if (now - segment->stalledSinceMs.load() < STALLED_RECORD_TIMEOUT_MS)
+                break;
+            continue;
+        }
+        if (record.flags & SHARED_RECORD_SEEDED)
+            continue;
+        long long rank = store.insert(record.name, record.score);
+        if (rank < 0) {
+            ok = false;
+            break;
+        }
+        record.rank.store((int)rank, std::memory_order_release);
+    }
+    segment->persisted.store(sequence, std::memory_order_release);
+    segment->storedEntries.store(store.size());
+
+    // highscore.txt follows the shared high score, replaced atomically
+    int           saved = 0;
+    std::ifstream infile(HIGHSCORE_FILE);
+    infile >> saved;
+    int high = segment->highScore.load();
+    if (high > saved) {
+        std::string tmpPath = std::string(HIGHSCORE_FILE) + ".tmp";
+        FILE       *file    = fopen(tmpPath.c_str(), "w");
+        if (file) {
+            fprintf(file, "%d", high);
+            bool written = fflush(file) == 0 && fsync(fileno(file)) == 0;
+            written      = fclose(file) == 0 && written;
+            ok = written && rename(tmpPath.c_str(), HIGHSCORE_FILE) == 0 && ok;
+        }
+    }
+    return ok;
+}
+
+void SharedLeaderboard::persistAsync() {
+    waitForPersist();
+    persister = std::thread([this] { persistNow(); });
+}
+
+void SharedLeaderboard::waitForPersist() {
+    if (persister.joinable())
+        persister.join();
+}
+
+long long SharedLeaderboard::rankOf(std::uint32_t sequence, int timeoutMs) const {
+    if (sequence == NO_SEQUENCE)
+        return -1;
+    const SharedRecord &record = segment->records[sequence & RECORD_MASK];
+    for (int waited = 0; waited <= timeoutMs; ++waited) {
+        if (record.ready.load(std::memory_order_acquire) != sequence + 1)
+            return -1; // Recycled long ago
+        int rank = record.rank.load(std::memory_order_acquire);
+        if (rank != 0)
+            return rank;
+        sleepMs(1);
+    }
+    return -1;
+}
+
+std::vector<LeaderboardEntry> SharedLeaderboard::top(int k) const {
+    std::vector<LeaderboardEntry> entries;
+    for (int i = 0; i < std::min(k, LEADERBOARD_TOP_K); ++i) {
+        std::uint64_t key = segment->top[i].load(std::memory_order_acquire);
+        if (key == 0)
+            break;
+        std::uint32_t       sequence = keySequence(key);
+        const SharedRecord &record   = segment->records[sequence & RECORD_MASK];
+
+        // Copy, then make sure the record wasn't rewritten underneath us
+        char name[sizeof(record.name)];
+        bool valid = record.ready.load(std::memory_order_acquire) == sequence + 1;
+        memcpy(name, record.name, sizeof(name));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        valid = valid && record.ready.load(std::memory_order_relaxed) == sequence + 1;
+        name[sizeof(name) - 1] = '\0';
+        entries.push_back({valid ? std::string(name) : std::string("?"), keyScore(key)});
+    }
+    return entries;
+}
@@ -0,0 +1,95 @@
+// shared_leaderboard.h - 여러 게임 프로세스가 함께 쓰는 공유 메모리 랭킹
+// ranking.shm 파일을 MAP_SHARED 로 매핑해서 같은 디렉터리의 모든 게임이 같은 세그먼트를 본다.
+//
+// - 상위 K개는 (점수 << 32 | ~순번) 으로 묶은 64비트 키 배열이다. 삽입은 위에서부터 내려가며
+//   자기보다 작은 키를 CAS 로 밀어내고, 밀려난 키를 들고 계속 내려간다. 칸의 값은 커지기만 하므로
+//   락 없이도 항상 내림차순이 유지되고, 끝에서 떨어지는 키만 버려진다.
+// - 게임 기록은 순번으로 자리를 잡는 링(records)에 들어간다. 디스크 저장(Leaderboard)은
+//   ranking.lock 을 flock 으로 잡은 프로세스 하나가 링에서 아직 저장 안 된 기록을 꺼내 처리한다.
+//   그래서 ranking.dat / ranking.log / highscore.txt 에 쓰는 프로세스는 언제나 하나뿐이다.
+// - 최고 점수도 세그먼트 안의 원자 변수로 CAS 갱신한다.
+
+#ifndef SHARED_LEADERBOARD_H
+#define SHARED_LEADERBOARD_H
+
+#include "leaderboard.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SHARED_LEADERBOARD_FILE "ranking.shm"
+#define LEADERBOARD_LOCK_FILE   "ranking.lock"
+#define HIGHSCORE_FILE          "highscore.txt"
+#define SHARED_RECORD_CAPACITY  16384 // Power of two; games that can wait to be persisted
+#define SHARED_RECORD_SEEDED    1     // Copied from the store when the segment was created
+#define NO_SEQUENCE             0xffffffffu
+
+struct SharedRecord {
+    std::atomic<std::uint32_t> ready;    // sequence + 1 once the fields below are complete
+    std::atomic<std::int32_t>  rank;     // Rank in the store once persisted, 0 while pending
+    std::int32_t               score;
+    std::uint32_t              flags;    // SHARED_RECORD_SEEDED
+    char                       name[48]; // UTF-8, NUL terminated
+};
+static_assert(sizeof(SharedRecord) == 64, "records are one cache line");
+
+struct SharedLeaderboardSegment {
+    char                       magic[4]; // "SNKS"
+    std::uint32_t              version;
+    std::atomic<std::uint32_t> state;           // 0 new, 1 being seeded, 2 ready
+    std::atomic<std::uint32_t> topVersion;      // Bumped whenever top[] changes
+    std::atomic<std::int32_t>  highScore;       // Best score ever
+    std::atomic<std::uint32_t> nextSequence;    // Next record to hand out
+    std::atomic<std::uint32_t> persisted;       // Records below this are in the store
+    std::atomic<std::int64_t>  storedEntries;   // Store size after the last persist
+    std::atomic<std::uint32_t> stalledSequence; // Unfinished record blocking the persister
+    std::atomic<std::int64_t>  stalledSinceMs;  // ...and since when (CLOCK_MONOTONIC)
+
+    alignas(64) std::atomic<std::uint64_t> top[LEADERBOARD_TOP_K]; // Best first, 0 = empty
+    alignas(64) SharedRecord records[SHARED_RECORD_CAPACITY];
+    // sequence + 1 when that sequence was given up because its ring slot still held a
+    // record shown in top[]; the persister skips it
+    std::atomic<std::uint32_t> skipped[SHARED_RECORD_CAPACITY];
+};
+
+struct SharedLeaderboard {
+    ~SharedLeaderboard();
+
+    // Maps (creating and seeding from the store if needed) the shared segment.
+    bool attach(const char *path = SHARED_LEADERBOARD_FILE);
+
+    // Lock-free. Publishes the game to every attached process and returns its sequence
+    // number, used to ask for its rank once persisted.
+    std::uint32_t insert(const std::string &name, int score);
+
+    // Drains unpersisted records into the store on a background thread.
+    void persistAsync();
+    // Same, on the calling thread. Returns false if the store couldn't be written.
+    bool persistNow();
+    // Joins a running background persist.
+    void waitForPersist();
+
+    // Store rank of a record, waiting up to `timeoutMs` for it to be persisted.
+    // Returns -1 if it isn't known by then.
+    long long rankOf(std::uint32_t sequence, int timeoutMs) const;
+    long long storedEntries() const { return segment->storedEntries.load(); }
+
+    std::vector<LeaderboardEntry> top(int k = LEADERBOARD_TOP_K) const;
+    std::uint32_t topVersion() const { return segment->topVersion.load(); }
+
+    int  highScore() const { return segment->highScore.load(); }
+    void offerHighScore(int score);
+
+  private:
+    void seed();
+    void pushTop(std::uint64_t key);
+    bool pinnedByTop(std::uint32_t sequence) const;
+
+    SharedLeaderboardSegment *segment = nullptr;
+    std::thread               persister;
+};
+
+#endif
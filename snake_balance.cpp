@@ -0,0 +1,369 @@
+// snake_balance.cpp - 스테이지 밸런스 몬테카를로 시뮬레이터
+// 규칙 값(GameRules)의 격자 위 각 점마다 자동 조종으로 헤드리스 게임을 많이 돌려서
+// 스테이지별 클리어율, 게임 오버 이유(gameOverReason) 분포, 점수 백분위를 출력한다.
+//
+// 게임은 GAMES_PER_CHUNK 판씩 묶어 작업 훔치기 풀에 넘긴다. 묶음마다 자기 PCG32 스트림에서
+// 시드를 뽑고 결과는 더하기만 하므로, 스레드 수나 실행 순서와 상관없이 같은 결과가 나온다.
+// 작업자는 자기 GameState/Autopilot 을 쓰고 묶음이 끝날 때만 잠금을 잡는다.
+//
+// Run: ./snake_balance [--games N] [--threads N] [--seed S] [--board HxW]
+//                      [--vary NAME=ALT,ALT,...]...
+//   NAME 은 GameRules 멤버 이름 (예: stageTurnLimitPerStage, mission_gate_per_stage,
+//   innerWallProbability, maxGrowthItems, itemLifespan).
+//   ALT 는 값 하나(모든 스테이지), a/b/c/d (스테이지별), xF (기본값의 F 배) 중 하나.
+//   예: ./snake_balance --games 20000 --vary stageTurnLimitPerStage=x0.8,x1,x1.2
+
+#include "autopilot.h"
+#include "snake_engine.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define GAMES_PER_CHUNK 256 // Games per pool task and per RNG stream
+#define MAX_GRID_POINTS 4096
+#define REASONS 8 // gameOverReason codes 0..7
+
+static const char *const reasonNames[REASONS] = {"",      "U-turn", "wall", "self",
+                                                 "turns", "short",  "gate", "quit"};
+
+// --- Rule knobs ---
+
+static const char *const knobNames[] = {
+    "innerWallProbability",     "gateRespawnIntervalPerStage", "stageTurnLimitPerStage",
+    "mission_length_per_stage", "mission_growth_per_stage",    "mission_poison_per_stage",
+    "mission_gate_per_stage",   "maxGrowthItems",              "maxPoisonItems",
+    "itemLifespan",             "layoutPerStage",
+};
+static const int KNOBS = sizeof(knobNames) / sizeof(knobNames[0]);
+
+// Where knob `k` lives in `rules`: `count` doubles at *real, or `count` ints at *whole.
+static int knobValues(GameRules &rules, int k, double *&real, int *&whole) {
+    real  = nullptr;
+    whole = nullptr;
+    switch (k) {
+    case 0: real = rules.innerWallProbability; return STAGES;
+    case 1: whole = rules.gateRespawnIntervalPerStage; return STAGES;
+    case 2: whole = rules.stageTurnLimitPerStage; return STAGES;
+    case 3: whole = rules.mission_length_per_stage; return STAGES;
+    case 4: whole = rules.mission_growth_per_stage; return STAGES;
+    case 5: whole = rules.mission_poison_per_stage; return STAGES;
+    case 6: whole = rules.mission_gate_per_stage; return STAGES;
+    case 7: whole = &rules.maxGrowthItems; return 1;
+    case 8: whole = &rules.maxPoisonItems; return 1;
+    case 9: whole = &rules.itemLifespan; return 1;
+    default: whole = rules.layoutPerStage; return STAGES;
+    }
+}
+
+static void setKnob(GameRules &rules, int k, const std::vector<double> &values) {
+    double *real;
+    int    *whole;
+    int     count = knobValues(rules, k, real, whole);
+    for (int i = 0; i < count; ++i) {
+        if (real)
+            real[i] = values[i];
+        else
+            whole[i] = (int)std::lround(values[i]);
+    }
+}
+
+// "v", "a/b/c/d" or "xF" into one value per stage (or a single value for a scalar knob).
+static bool parseAlternative(int k, const std::string &text, std::vector<double> &values) {
+    GameRules defaults = defaultRules;
+    double   *real;
+    int      *whole;
+    int       count = knobValues(defaults, k, real, whole);
+    values.clear();
+    if (!text.empty() && text[0] == 'x') {
+        char  *end;
+        double factor = strtod(text.c_str() + 1, &end);
+        if (*end != '\0' || end == text.c_str() + 1)
+            return false;
+        for (int i = 0; i < count; ++i)
+            values.push_back((real ? real[i] : whole[i]) * factor);
+        return true;
+    }
+    const char *p = text.c_str();
+    for (;;) {
+        char  *end;
+        double value = strtod(p, &end);
+        if (end == p)
+            return false;
+        values.push_back(value);
+        if (*end == '\0')
+            break;
+        if (*end != '/')
+            return false;
+        p = end + 1;
+    }
+    if ((int)values.size() == 1)
+        values.assign(count, values[0]);
+    return (int)values.size() == count;
+}
+
+static bool validRules(const GameRules &rules) {
+    for (int s = 0; s < STAGES; ++s) {
+        if (rules.innerWallProbability[s] < 0 || rules.innerWallProbability[s] > 100 ||
+            rules.gateRespawnIntervalPerStage[s] < 1 || rules.stageTurnLimitPerStage[s] < 1 ||
+            rules.mission_length_per_stage[s] < 0 || rules.mission_growth_per_stage[s] < 0 ||
+            rules.mission_poison_per_stage[s] < 0 || rules.mission_gate_per_stage[s] < 0 ||
+            rules.layoutPerStage[s] < LAYOUT_SCATTER || rules.layoutPerStage[s] > LAYOUT_ROOMS)
+            return false;
+    }
+    return rules.maxGrowthItems >= 0 && rules.maxPoisonItems >= 0 &&
+           rules.maxGrowthItems + rules.maxPoisonItems <= MAX_LIVE_ITEMS && rules.itemLifespan >= 1;
+}
+
+// --- Grid ---
+
+struct Axis {
+    int                              knob;
+    std::vector<std::string>         labels;
+    std::vector<std::vector<double>> values;
+};
+
+struct StageTotals {
+    long long        reached = 0; // Games that started the stage
+    long long        cleared = 0;
+    long long        reasons[REASONS] = {0}; // Games that ended here, by gameOverReason
+    std::vector<int> scores;                 // Final scores of games that ended here or won
+};
+
+struct GridPoint {
+    GameRules   rules;
+    std::string label;
+    std::mutex  lock; // Guards everything below, taken once per chunk
+    long long   games = 0, wins = 0, ticks = 0;
+    StageTotals stages[STAGES];
+};
+
+struct ChunkTask {
+    GridPoint         *point;
+    int                count;  // Games to play
+    unsigned long long seed;   // --seed
+    unsigned           stream; // PCG32 stream the game seeds come from
+    int                height, width;
+};
+
+static void runChunk(void *arg) {
+    const ChunkTask &task = *(const ChunkTask *)arg;
+
+    // Per worker, reused across chunks so the boards aren't reallocated
+    static thread_local GameState state;
+    static thread_local Autopilot autopilot;
+
+    GameRng seeds;
+    seeds.seed(task.seed, task.stream);
+
+    long long   wins = 0, ticks = 0;
+    StageTotals local[STAGES];
+    for (int i = 0; i < task.count; ++i) {
+        initGame(state, seeds(), task.height, task.width, task.point->rules);
+        autopilot.reset();
+        while (!state.gameOver) {
+            step(state, autopilot.choose(state));
+            ticks++;
+        }
+
+        int last = std::min(state.currentStage, STAGES - 1);
+        for (int s = 0; s <= last; ++s)
+            local[s].reached++;
+        for (int s = 0; s < state.currentStage; ++s)
+            local[s].cleared++;
+        if (state.gameWon)
+            wins++;
+        else
+            local[last].reasons[state.gameOverReason & (REASONS - 1)]++;
+        local[last].scores.push_back(finalScore(state));
+    }
+
+    GridPoint                  &point = *task.point;
+    std::lock_guard<std::mutex> guard(point.lock);
+    point.games += task.count;
+    point.wins += wins;
+    point.ticks += ticks;
+    for (int s = 0; s < STAGES; ++s) {
+        StageTotals &total = point.stages[s];
+        total.reached += local[s].reached;
+        total.cleared += local[s].cleared;
+        for (int r = 0; r < REASONS; ++r)
+            total.reasons[r] += local[s].reasons[r];
+        total.scores.insert(total.scores.end(), local[s].scores.begin(), local[s].scores.end());
+    }
+}
+
+// Nearest-rank percentile of `scores`, which it partially reorders.
+static int percentile(std::vector<int> &scores, int pct) {
+    size_t rank = (scores.size() * pct + 99) / 100;
+    rank        = rank > 0 ? rank - 1 : 0;
+    std::nth_element(scores.begin(), scores.begin() + rank, scores.end());
+    return scores[rank];
+}
+
+static void printPoint(GridPoint &point, int index, int total) {
+    printf("\n[%d/%d] %s\n", index + 1, total, point.label.c_str());
+    printf("  games %lld  won %lld (%.2f%%)  %.0f ticks/game\n", point.games, point.wins,
+           100.0 * point.wins / point.games, (double)point.ticks / point.games);
+    printf("  stage  reached   clear%%");
+    for (int r = 1; r < REASONS - 1; ++r)
+        printf(" %7s", reasonNames[r]);
+    printf("  | score p10   p50   p90   p99\n");
+    for (int s = 0; s < STAGES; ++s) {
+        StageTotals &stage = point.stages[s];
+        if (stage.reached == 0)
+            break;
+        printf("  %-5d %8lld  %6.2f%%", s + 1, stage.reached,
+               100.0 * stage.cleared / stage.reached);
+        for (int r = 1; r < REASONS - 1; ++r)
+            printf(" %6.2f%%", 100.0 * stage.reasons[r] / stage.reached);
+        if (stage.scores.empty()) {
+            printf("  |      -\n");
+            continue;
+        }
+        printf("  |  %6d %5d %5d %5d\n", percentile(stage.scores, 10),
+               percentile(stage.scores, 50), percentile(stage.scores, 90),
+               percentile(stage.scores, 99));
+    }
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--games N] [--threads N] [--seed S] [--board HxW] "
+            "[--vary NAME=ALT,ALT,...]...\n"
+            "  ALT: V (every stage), A/B/C/D (per stage) or xF (F times the default)\n"
+            "  NAME:",
+            argv0);
+    for (int k = 0; k < KNOBS; ++k)
+        fprintf(stderr, " %s", knobNames[k]);
+    fprintf(stderr, "\n");
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    long long          games   = 10000;
+    int                threads = (int)std::thread::hardware_concurrency();
+    unsigned long long seed    = 1;
+    int                height = DEFAULT_HEIGHT, width = DEFAULT_WIDTH;
+    std::vector<Axis>  axes;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg  = argv[i];
+        const char *next = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--games") == 0 && next) {
+            games = atoll(argv[++i]);
+        } else if (strcmp(arg, "--threads") == 0 && next) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && next) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--board") == 0 && next) {
+            if (!parseBoardSize(argv[++i], height, width))
+                return usage(argv[0]);
+        } else if (strcmp(arg, "--vary") == 0 && next) {
+            std::string spec = argv[++i];
+            size_t      eq   = spec.find('=');
+            Axis        axis;
+            axis.knob = -1;
+            for (int k = 0; k < KNOBS && eq != std::string::npos; ++k)
+                if (spec.compare(0, eq, knobNames[k]) == 0)
+                    axis.knob = k;
+            if (axis.knob < 0)
+                return usage(argv[0]);
+            size_t start = eq + 1;
+            for (;;) {
+                size_t              comma = spec.find(',', start);
+                std::string         alt   = spec.substr(start, comma - start);
+                std::vector<double> values;
+                if (!parseAlternative(axis.knob, alt, values)) {
+                    fprintf(stderr, "bad value '%s' for %s\n", alt.c_str(), knobNames[axis.knob]);
+                    return 1;
+                }
+                axis.labels.push_back(alt);
+                axis.values.push_back(values);
+                if (comma == std::string::npos)
+                    break;
+                start = comma + 1;
+            }
+            axes.push_back(axis);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (games < 1)
+        return usage(argv[0]);
+    if (threads < 1)
+        threads = 1;
+
+    // Cartesian product of the axes, first axis varying slowest
+    long long pointCount = 1;
+    for (const Axis &axis : axes)
+        pointCount *= (long long)axis.labels.size();
+    if (pointCount > MAX_GRID_POINTS) {
+        fprintf(stderr, "%lld grid points; at most %d\n", pointCount, MAX_GRID_POINTS);
+        return 1;
+    }
+    std::vector<GridPoint> points(pointCount);
+    for (long long p = 0; p < pointCount; ++p) {
+        GridPoint &point = points[p];
+        point.rules      = defaultRules;
+        long long  rest  = p;
+        for (int a = (int)axes.size() - 1; a >= 0; --a) {
+            const Axis &axis   = axes[a];
+            int         choice = (int)(rest % axis.labels.size());
+            rest /= axis.labels.size();
+            setKnob(point.rules, axis.knob, axis.values[choice]);
+            point.label = std::string(knobNames[axis.knob]) + "=" + axis.labels[choice] +
+                          (point.label.empty() ? "" : "  ") + point.label;
+        }
+        if (point.label.empty())
+            point.label = "default rules";
+        if (!validRules(point.rules)) {
+            fprintf(stderr, "rules out of range at %s\n", point.label.c_str());
+            return 1;
+        }
+    }
+
+    // Chunk c of every point draws from stream c, so points are compared on the same seeds
+    std::vector<ChunkTask> tasks;
+    for (GridPoint &point : points) {
+        for (long long first = 0; first < games; first += GAMES_PER_CHUNK) {
+            ChunkTask task;
+            task.point  = &point;
+            task.count  = (int)std::min<long long>(GAMES_PER_CHUNK, games - first);
+            task.seed   = seed;
+            task.stream = (unsigned)(first / GAMES_PER_CHUNK);
+            task.height = height;
+            task.width  = width;
+            tasks.push_back(task);
+        }
+    }
+
+    auto             start = std::chrono::steady_clock::now();
+    WorkStealingPool pool;
+    pool.start(threads);
+    for (ChunkTask &task : tasks)
+        pool.submit({runChunk, &task});
+    pool.stop(); // Drains the queue
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalTicks = 0;
+    for (const GridPoint &point : points)
+        totalTicks += point.ticks;
+    printf("board: %dx%d  seed: %llu  grid points: %lld  games/point: %lld  threads: %d\n",
+           height, width, seed, pointCount, games, threads);
+    printf("elapsed: %.3f s  (%.0f games/s, %.2f M ticks/s)\n", seconds,
+           pointCount * games / seconds, totalTicks / seconds / 1e6);
+    printf("columns: games reaching each stage, the share that cleared it and how the rest ended\n"
+           "(gameOverReason); scores are final scores of games that ended in the stage or won\n");
+    for (long long p = 0; p < pointCount; ++p)
+        printPoint(points[p], (int)p, (int)pointCount);
+    return 0;
+}
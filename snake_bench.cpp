@@ -0,0 +1,668 @@
+// snake_bench.cpp - 엔진/UI 마이크로 벤치마크 모음
+// 벤치마크마다 같은 측정을 BENCH_REPEATS 번 되풀이해서 연산 한 번당 ns 의 중앙값과 최솟값을 낸다.
+// 결과는 표로 출력하고, --json 을 주면 커밋끼리 비교할 수 있도록 JSON 파일로도 쓴다.
+// 같은 이름(name)과 조건(params)의 항목끼리 비교하면 된다.
+// Run: ./snake_bench [--json FILE] [--label TEXT] [--filter TEXT]   (make bench)
+
+#include "ansi_renderer.h"
+#include "broadcast.h"
+#include "curses_board.h"
+#include "leaderboard.h"
+#include "map_generator.h"
+#include "snake_engine.h"
+#include "snapshot.h"
+#include "tick_scheduler.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <ncurses.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#define BENCH_REPEATS 5 // Measurements per benchmark; the median is reported
+
+// --- Harness ---
+
+struct BenchResult {
+    std::string name;   // What was measured, e.g. "spawnGrowthItem"
+    std::string params; // "key=value,..." telling runs of the same name apart
+    long long   ops      = 0; // Operations per measurement
+    double      medianNs = 0; // Per operation
+    double      minNs    = 0;
+    std::vector<std::pair<std::string, double>> metrics; // Other numbers worth tracking
+};
+
+static std::vector<BenchResult> results;
+static const char              *nameFilter = nullptr; // --filter: only names containing this
+
+static bool selected(const char *name) { return !nameFilter || strstr(name, nameFilter); }
+
+// Calls `once`, which performs `ops` operations and returns the nanoseconds they took,
+// BENCH_REPEATS times and records the per-operation median and minimum.
+template <typename Fn>
+static BenchResult &measure(const char *name, const std::string &params, long long ops, Fn once) {
+    fprintf(stderr, "  %s %s\n", name, params.c_str());
+    std::vector<double> perOp;
+    for (int r = 0; r < BENCH_REPEATS; ++r)
+        perOp.push_back(once() / ops);
+    std::sort(perOp.begin(), perOp.end());
+
+    BenchResult result;
+    result.name     = name;
+    result.params   = params;
+    result.ops      = ops;
+    result.medianNs = perOp[BENCH_REPEATS / 2];
+    result.minNs    = perOp[0];
+    results.push_back(result);
+    return results.back();
+}
+
+static std::string param(const char *key, double value) {
+    char text[64];
+    snprintf(text, sizeof(text), "%s=%g", key, value);
+    return text;
+}
+
+static void printResults() {
+    printf("%-26s %-28s %12s %12s %9s  %s\n", "name", "params", "median ns", "min ns", "ops",
+           "metrics");
+    for (const BenchResult &r : results) {
+        printf("%-26s %-28s %12.1f %12.1f %9lld ", r.name.c_str(), r.params.c_str(), r.medianNs,
+               r.minNs, r.ops);
+        for (const auto &metric : r.metrics)
+            printf(" %s=%g", metric.first.c_str(), metric.second);
+        printf("\n");
+    }
+}
+
+// Names and params are plain ASCII, so nothing needs escaping.
+static bool writeJson(const char *path, const char *label) {
+    FILE *out = fopen(path, "w");
+    if (!out)
+        return false;
+    fprintf(out, "{\n  \"label\": \"%s\",\n  \"compiler\": \"%s\",\n  \"repeats\": %d,\n",
+            label, __VERSION__, BENCH_REPEATS);
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"params\": \"%s\", \"ops\": %lld, "
+                "\"median_ns\": %.3f, \"min_ns\": %.3f, \"metrics\": {",
+                r.name.c_str(), r.params.c_str(), r.ops, r.medianNs, r.minNs);
+        for (size_t m = 0; m < r.metrics.size(); ++m)
+            fprintf(out, "%s\"%s\": %g", m ? ", " : "", r.metrics[m].first.c_str(),
+                    r.metrics[m].second);
+        fprintf(out, "}}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+    return true;
+}
+
+// --- Engine ---
+
+// No inner walls, missions and turn limits out of reach: a snake circling the board never
+// has a reason to stop.
+static const GameRules &openRules() {
+    static GameRules rules = [] {
+        GameRules r = defaultRules;
+        for (int s = 0; s < STAGES; ++s) {
+            r.layoutPerStage[s]           = LAYOUT_SCATTER;
+            r.innerWallProbability[s]     = 0;
+            r.stageTurnLimitPerStage[s]   = 1 << 30;
+            r.mission_length_per_stage[s] = 1 << 30;
+        }
+        return r;
+    }();
+    return rules;
+}
+
+// Clockwise around the rectangle two cells inside the border; straight right until the
+// snake reaches it.
+static int ringDirection(const GameState &state) {
+    int top = 2, left = 2, bottom = state.height - 3, right = state.width - 3;
+    int y = state.headY, x = state.headX;
+    if (y == top && x < right)
+        return RIGHT;
+    if (x == right && y < bottom)
+        return DOWN;
+    if (y == bottom && x > left)
+        return LEFT;
+    if (x == left && y > top)
+        return UP;
+    return RIGHT;
+}
+
+// One tick of the circling snake; a new game (not timed) when it ran into itself.
+static long long ringTick(GameState &state, long long &restarts) {
+    updateDirection(state, ringDirection(state));
+    moveSnake(state);
+    if (state.gameOverReason == 0)
+        return 0;
+    long long start = monotonicNs();
+    initGame(state, (unsigned)restarts++, state.height, state.width, openRules());
+    return monotonicNs() - start;
+}
+
+static void benchMoveSnake() {
+    if (!selected("moveSnake"))
+        return;
+    for (int size : {21, 81, 256, 1024}) {
+        GameState state;
+        initGame(state, 1, size, size, openRules());
+        long long restarts = 0;
+        measure("moveSnake", param("board", size), 200000, [&] {
+            long long untimed = 0, start = monotonicNs();
+            for (int i = 0; i < 200000; ++i)
+                untimed += ringTick(state, restarts);
+            return (double)(monotonicNs() - start - untimed);
+        }).metrics.push_back({"restarts", (double)restarts});
+    }
+}
+
+// Fresh stage with no items, filled with snake cells until occupied / area reaches `occupancy`.
+static void prepareBoard(GameState &state, double occupancy) {
+    initGame(state, 42);
+    while (state.itemCount > 0)
+        removeItem(state, state.items[0].cell);
+
+    int area = state.height * state.width;
+    while (area - state.freeCells.size() < occupancy * area && state.freeCells.size() > 1) {
+        int cell = state.freeCells.at(state.rng() % state.freeCells.size());
+        setCell(state, cell, CELL_SNAKE);
+    }
+}
+
+// The pre-index spawn: count items with a full scan, then rejection-sample an empty cell.
+static int legacySpawnGrowthItem(GameState &state) {
+    int count = 0;
+    for (int i = 0; i < state.height; ++i)
+        for (int j = 0; j < state.width; ++j)
+            if (cellAt(state, i, j) == CELL_GROWTH)
+                count++;
+    if (count >= state.rules->maxGrowthItems)
+        return -1;
+
+    int y, x;
+    do {
+        y = state.rng() % state.height;
+        x = state.rng() % state.width;
+    } while (cellAt(state, y, x) != CELL_EMPTY);
+    setCell(state, y * state.width + x, CELL_GROWTH);
+    return y * state.width + x;
+}
+
+// Each spawned item is removed again so the occupancy stays fixed.
+template <typename SpawnFn>
+static void timeSpawns(const char *name, double level, int iterations, SpawnFn fn) {
+    GameState state;
+    prepareBoard(state, level);
+    BenchResult &result = measure(name, param("occupancy", level), iterations, [&] {
+        long long start = monotonicNs();
+        for (int i = 0; i < iterations; ++i)
+            removeItem(state, fn(state));
+        return (double)(monotonicNs() - start);
+    });
+    int area = state.height * state.width;
+    result.metrics.push_back({"actual_occupancy", 1.0 - (double)state.freeCells.size() / area});
+    result.metrics.push_back({"free_cells", (double)state.freeCells.size()});
+}
+
+static void benchSpawnOccupancy() {
+    for (double level : {0.03, 0.10, 0.25, 0.50, 0.75, 0.90, 0.95, 0.99}) {
+        if (selected("spawnGrowthItem"))
+            timeSpawns("spawnGrowthItem", level, 100000, spawnGrowthItem);
+        if (selected("legacySpawnGrowthItem"))
+            timeSpawns("legacySpawnGrowthItem", level, 20000, legacySpawnGrowthItem);
+    }
+}
+
+// The pre-index gate spawn: collect every wall next to an empty cell, then pick two.
+static void legacySpawnGates(GameState &state) {
+    static const int dy[4] = {-1, 1, 0, 0};
+    static const int dx[4] = {0, 0, -1, 1};
+    const int        H     = state.height;
+    const int        W     = state.width;
+
+    if (state.gateA.first != -1)
+        setCell(state, state.gateA.first * W + state.gateA.second, CELL_WALL);
+    if (state.gateB.first != -1)
+        setCell(state, state.gateB.first * W + state.gateB.second, CELL_WALL);
+    state.gateA = {-1, -1};
+    state.gateB = {-1, -1};
+
+    std::vector<std::pair<int, int>> wallCandidates;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            if (cellAt(state, y, x) != CELL_WALL)
+                continue;
+            for (int i = 0; i < 4; ++i) {
+                int adjY = y + dy[i], adjX = x + dx[i];
+                if (adjY >= 0 && adjY < H && adjX >= 0 && adjX < W &&
+                    cellAt(state, adjY, adjX) == CELL_EMPTY) {
+                    wallCandidates.push_back({y, x});
+                    break;
+                }
+            }
+        }
+    }
+    if (wallCandidates.size() < 2)
+        return;
+    int count = (int)wallCandidates.size();
+    for (int i = 0; i < 2; ++i)
+        std::swap(wallCandidates[i], wallCandidates[i + state.rng.below(count - i)]);
+    state.gateA = wallCandidates[0];
+    state.gateB = wallCandidates[1];
+    setCell(state, state.gateA.first * W + state.gateA.second, CELL_GATE);
+    setCell(state, state.gateB.first * W + state.gateB.second, CELL_GATE);
+}
+
+// Gate respawns and exit lookups on a fresh stage-4 board of each size.
+static void benchGates() {
+    for (int size : {21, 81, 256, 1024}) {
+        GameState state;
+        initGame(state, 42, size, size);
+        initStage(state, STAGES - 1);
+        int iterations = std::max(20, 4000000 / (size * size));
+
+        if (selected("spawnGates")) {
+            measure("spawnGates", param("board", size), iterations, [&] {
+                long long start = monotonicNs();
+                for (int i = 0; i < iterations; ++i)
+                    spawnGates(state);
+                return (double)(monotonicNs() - start);
+            }).metrics.push_back({"candidates", (double)state.gateCandidates.size()});
+        }
+        if (selected("legacySpawnGates")) {
+            measure("legacySpawnGates", param("board", size), iterations, [&] {
+                long long start = monotonicNs();
+                for (int i = 0; i < iterations; ++i)
+                    legacySpawnGates(state);
+                return (double)(monotonicNs() - start);
+            });
+        }
+        if (selected("calculateExitDirection") && state.gateA.first >= 0) {
+            const int ops  = 1000000;
+            int       sink = 0;
+            measure("calculateExitDirection", param("board", size), ops, [&] {
+                long long start = monotonicNs();
+                for (int i = 0; i < ops; ++i)
+                    sink += calculateExitDirection(state, state.gateB.first, state.gateB.second,
+                                                   i & 3);
+                return (double)(monotonicNs() - start);
+            }).metrics.push_back({"checksum", (double)(sink & 0xffff)});
+        }
+    }
+}
+
+static void benchInitStage() {
+    if (!selected("initStage"))
+        return;
+    for (int size : {21, 81, 256, 1024}) {
+        GameState state;
+        initGame(state, 42, size, size);
+        int ops = std::max(4, 2000000 / (size * size));
+        measure("initStage", param("board", size), ops, [&] {
+            long long start = monotonicNs();
+            for (int i = 0; i < ops; ++i)
+                initStage(state, i % STAGES);
+            return (double)(monotonicNs() - start);
+        });
+    }
+}
+
+// Generation time of each layout kind by board size, with how often it had to be fixed up.
+static void benchLayouts() {
+    if (!selected("generateLayout"))
+        return;
+    const char *const kinds[] = {"scatter", "maze", "rooms"};
+    for (int size : {21, 81, 256, 1024}) {
+        for (int kind = LAYOUT_SCATTER; kind <= LAYOUT_ROOMS; ++kind) {
+            GameRules rules = defaultRules;
+            for (int s = 0; s < STAGES; ++s)
+                rules.layoutPerStage[s] = kind;
+            GameState state;
+            initGame(state, 42, size, size, rules);
+
+            int         maps     = std::max(2, std::min(1000, (2 << 20) / (size * size)));
+            long long   attempts = 0, carved = 0;
+            std::string params   = param("board", size) + ",layout=" + kinds[kind];
+            BenchResult &result  = measure("generateLayout", params, maps, [&] {
+                long long start = monotonicNs();
+                for (int i = 0; i < maps; ++i) {
+                    LayoutReport report = generateLayout(state, i % STAGES);
+                    attempts += report.attempts;
+                    carved += report.carved;
+                }
+                return (double)(monotonicNs() - start);
+            });
+            double generated = (double)maps * BENCH_REPEATS;
+            result.metrics.push_back({"attempts", attempts / generated});
+            result.metrics.push_back({"carved", carved / generated});
+        }
+    }
+}
+
+// --- Ranking store ---
+
+#define BENCH_RANKING_ENTRIES 100000
+
+// Runs in a scratch directory, since the store imports ./ranking.txt when it starts empty.
+static void benchRanking() {
+    if (!selected("Leaderboard"))
+        return;
+    char dir[] = "/tmp/snake_bench.XXXXXX";
+    char cwd[4096];
+    if (!mkdtemp(dir) || !getcwd(cwd, sizeof(cwd)) || chdir(dir) != 0) {
+        fprintf(stderr, "ranking benchmarks skipped: no scratch directory\n");
+        return;
+    }
+
+    // The old text format, best score first like saveRanking() used to keep it
+    FILE *text = fopen(LEGACY_RANKING_FILE, "w");
+    for (int i = 0; i < BENCH_RANKING_ENTRIES && text; ++i)
+        fprintf(text, "player%d %d\n", i, 2 * (BENCH_RANKING_ENTRIES - i));
+    if (text)
+        fclose(text);
+
+    std::string entries = param("entries", BENCH_RANKING_ENTRIES);
+    measure("Leaderboard::open", entries + ",import=text", 1, [] {
+        unlink(LEADERBOARD_BASE ".dat");
+        unlink(LEADERBOARD_BASE ".log");
+        long long   start = monotonicNs();
+        Leaderboard board;
+        board.open();
+        return (double)(monotonicNs() - start);
+    });
+    unlink(LEGACY_RANKING_FILE);
+
+    // What saveRanking() does without the shared segment: open, insert, close
+    unsigned  seed    = 1;
+    const int inserts = 500;
+    measure("Leaderboard::insert", entries + ",reopen=1", inserts, [&] {
+        long long start = monotonicNs();
+        for (int i = 0; i < inserts; ++i) {
+            seed = seed * 1103515245 + 12345;
+            Leaderboard board;
+            if (board.open())
+                board.insert("bench", (int)(seed >> 8) % (2 * BENCH_RANKING_ENTRIES));
+        }
+        return (double)(monotonicNs() - start);
+    });
+
+    Leaderboard board;
+    board.open();
+    long long                   total = board.size();
+    std::vector<LeaderboardRow> rows;
+    const int                   ops = 100000;
+    size_t topRows = 0;
+    measure("Leaderboard::top", entries, ops / 10, [&] {
+        long long start = monotonicNs();
+        for (int i = 0; i < ops / 10; ++i)
+            topRows += board.top().size();
+        return (double)(monotonicNs() - start);
+    }).metrics.push_back({"rows", (double)topRows / (ops / 10) / BENCH_REPEATS});
+    measure("Leaderboard::page", entries + ",rows=20", ops, [&] {
+        long long start = monotonicNs();
+        for (int i = 0; i < ops; ++i)
+            board.page((long long)(i * 7919LL) % total, 20, rows);
+        return (double)(monotonicNs() - start);
+    });
+
+    unlink(LEADERBOARD_BASE ".dat");
+    unlink(LEADERBOARD_BASE ".log");
+    if (chdir(cwd) != 0 || rmdir(dir) != 0)
+        fprintf(stderr, "couldn't remove %s\n", dir);
+}
+
+// --- ncurses board ---
+
+// drawBoard() plus refresh() on a screen that writes to /dev/null, as snake_game draws a
+// frame: a whole new board (stage change) and one tick's damage list.
+// Mean bytes written to `sink` per frame since offset `before`, over BENCH_REPEATS runs.
+static double bytesPerFrame(FILE *sink, off_t before, int frames) {
+    return (double)(lseek(fileno(sink), 0, SEEK_CUR) - before) / frames / BENCH_REPEATS;
+}
+
+static void benchCursesBoard() {
+    if (!selected("drawBoard"))
+        return;
+    setlocale(LC_ALL, "");
+    if (MB_CUR_MAX == 1)
+        setlocale(LC_ALL, "C.UTF-8"); // The glyphs are UTF-8 like in the game
+    setenv("TERM", "xterm-256color", 0);
+    setenv("LINES", "100", 1); // Room for the 81x81 board, which is 243 columns wide
+    setenv("COLUMNS", "300", 1);
+    FILE   *sink   = tmpfile(); // Its offset counts the bytes ncurses wrote
+    FILE   *source = fopen("/dev/null", "r");
+    SCREEN *screen = sink && source ? newterm(nullptr, sink, source) : nullptr;
+    if (!screen) {
+        fprintf(stderr, "drawBoard benchmarks skipped: no terminal description\n");
+        return;
+    }
+    set_term(screen);
+    initColors();
+
+    for (int size : {21, 81}) {
+        // Two different games, so every full frame really changes the screen
+        GameState states[2];
+        initGame(states[0], 1, size, size, openRules());
+        initGame(states[1], 2, size, size, openRules());
+        const int frames = size == 21 ? 2000 : 200;
+        off_t     before = lseek(fileno(sink), 0, SEEK_CUR);
+        measure("drawBoard", param("board", size) + ",frame=full", frames, [&] {
+            long long start = monotonicNs();
+            for (int i = 0; i < frames; ++i) {
+                erase();
+                drawBoard(states[i & 1], true);
+                refresh();
+            }
+            return (double)(monotonicNs() - start);
+        }).metrics.push_back({"bytes", bytesPerFrame(sink, before, frames)});
+
+        const int ticks    = 20000;
+        long long restarts = 0;
+        before             = lseek(fileno(sink), 0, SEEK_CUR);
+        measure("drawBoard", param("board", size) + ",frame=damage", ticks, [&] {
+            long long untimed = 0, start = monotonicNs();
+            for (int i = 0; i < ticks; ++i) {
+                long long tickStart = monotonicNs();
+                ringTick(states[0], restarts);
+                untimed += monotonicNs() - tickStart;
+                drawBoard(states[0], states[0].fullRedraw);
+                refresh();
+            }
+            return (double)(monotonicNs() - start - untimed);
+        }).metrics.push_back({"bytes", bytesPerFrame(sink, before, ticks)});
+    }
+
+    endwin();
+    delscreen(screen);
+    fclose(sink);
+    fclose(source);
+}
+
+// Bytes and write() calls per frame written through `screen`.
+static std::vector<std::pair<std::string, double>> frameMetrics(const AnsiRenderer &screen) {
+    return {{"bytes", screen.stats.bytesPerFrame()}, {"writes", screen.stats.writesPerFrame()}};
+}
+
+// The same frames as benchCursesBoard() through AnsiRenderer, one write() each.
+static void benchAnsiBoard() {
+    if (!selected("ansiFrame"))
+        return;
+    int sink = open("/dev/null", O_WRONLY);
+    for (int size : {21, 81}) {
+        GameState states[2];
+        initGame(states[0], 1, size, size, openRules());
+        initGame(states[1], 2, size, size, openRules());
+        AnsiRenderer      screen;
+        const std::string board  = param("board", size);
+        const int         frames = size == 21 ? 2000 : 200;
+        BenchResult      &full   = measure("ansiFrame", board + ",frame=full", frames, [&] {
+            long long start = monotonicNs();
+            for (int i = 0; i < frames; ++i) {
+                screen.clearScreen();
+                screen.drawBoard(states[i & 1], true);
+                screen.writeFrame(sink);
+            }
+            return (double)(monotonicNs() - start);
+        });
+        full.metrics = frameMetrics(screen);
+
+        screen.stats       = FrameStats();
+        const int ticks    = 20000;
+        long long restarts = 0;
+        BenchResult &damage = measure("ansiFrame", board + ",frame=damage", ticks, [&] {
+            long long untimed = 0, start = monotonicNs();
+            for (int i = 0; i < ticks; ++i) {
+                long long tickStart = monotonicNs();
+                ringTick(states[0], restarts);
+                untimed += monotonicNs() - tickStart;
+                screen.drawBoard(states[0], states[0].fullRedraw);
+                screen.writeFrame(sink);
+            }
+            return (double)(monotonicNs() - start - untimed);
+        });
+        damage.metrics = frameMetrics(screen);
+    }
+    close(sink);
+}
+
+// Saving and restoring a game in progress. The circling snake keeps its tail until it covers
+// most of its ring, so the body isn't the three starting cells.
+static void benchSnapshot() {
+    if (!selected("snapshot"))
+        return;
+    for (int size : {21, 81}) {
+        GameState state, restored;
+        initGame(state, 1, size, size, openRules());
+        long long restarts = 0;
+        const int ring     = 4 * (size - 5);
+        for (int i = 0; i < 2 * ring; ++i) {
+            CellIndex tail = state.snake.back();
+            ringTick(state, restarts);
+            if (state.snake.size() < ring - 8 && state.map[tail] == CELL_EMPTY) {
+                state.snake.pushBack(tail);
+                setCell(state, tail, CELL_SNAKE);
+            }
+        }
+
+        std::vector<std::uint8_t> bytes;
+        const std::string         board = param("board", size);
+        const int                 ops   = size == 21 ? 20000 : 2000;
+        BenchResult              &save  = measure("snapshotEncode", board, ops, [&] {
+            long long start = monotonicNs();
+            for (int i = 0; i < ops; ++i)
+                encodeSnapshot(state, bytes);
+            return (double)(monotonicNs() - start);
+        });
+        save.metrics = {{"bytes", (double)bytes.size()}, {"length", (double)state.snake.size()}};
+
+        bool         ok      = true;
+        BenchResult &restore = measure("snapshotDecode", board, ops, [&] {
+            long long start = monotonicNs();
+            for (int i = 0; i < ops; ++i)
+                ok &= decodeSnapshot(restored, bytes.data(), bytes.size(), openRules());
+            return (double)(monotonicNs() - start);
+        });
+        restore.metrics = {{"bytes", (double)bytes.size()}, {"ok", ok ? 1.0 : 0.0}};
+    }
+}
+
+// Broadcaster::publish() per tick with spectators that never read, so the sender thread keeps
+// dropping their backlog. The game thread's cost should not grow with the spectator count.
+// Ticks come back to back here, so the ring overflows and forces keyframes far more often
+// than in a game.
+static void benchBroadcast() {
+    if (!selected("broadcastPublish"))
+        return;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/snake_bench_%d.sock", (int)getpid());
+    for (int watchers : {0, 1, 16}) {
+        Broadcaster broadcaster;
+        if (!broadcaster.start(path)) {
+            fprintf(stderr, "  broadcastPublish: can't listen on %s\n", path);
+            return;
+        }
+        std::vector<int> clients;
+        for (int i = 0; i < watchers; ++i) {
+            sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            strcpy(address.sun_path, path);
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, (sockaddr *)&address, sizeof(address)) == 0)
+                clients.push_back(fd);
+            else if (fd >= 0)
+                close(fd);
+        }
+        usleep(3 * WATCH_POLL_MS * 1000); // Let the sender thread accept them
+
+        GameState state;
+        initGame(state, 1, 81, 81, openRules());
+        broadcaster.beginGame("bench");
+        const std::string spectators = param("spectators", watchers);
+        const int         ticks      = 20000;
+        long long         restarts   = 0;
+        BenchResult      &publish    = measure("broadcastPublish", spectators, ticks, [&] {
+            long long untimed = 0, start = monotonicNs();
+            for (int i = 0; i < ticks; ++i) {
+                untimed += ringTick(state, restarts);
+                broadcaster.publish(state, 0);
+                clearDamage(state);
+            }
+            return (double)(monotonicNs() - start - untimed);
+        });
+        broadcaster.endGame(state);
+        broadcaster.stop();
+        for (int fd : clients)
+            close(fd);
+        double sent     = broadcaster.messages ? broadcaster.messages : 1;
+        publish.metrics = {{"bytes", broadcaster.bytes / sent},
+                           {"overflows", (double)broadcaster.overflows}};
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *jsonPath = nullptr;
+    const char *label    = "";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            nameFilter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--json FILE] [--label TEXT] [--filter TEXT]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    benchMoveSnake();
+    benchSpawnOccupancy();
+    benchGates();
+    benchInitStage();
+    benchLayouts();
+    benchRanking();
+    benchCursesBoard();
+    benchAnsiBoard();
+    benchSnapshot();
+    benchBroadcast();
+
+    printResults();
+    if (jsonPath && !writeJson(jsonPath, label)) {
+        fprintf(stderr, "can't write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
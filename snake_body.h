@@ -0,0 +1,74 @@
+// snake_body.h - 고정 크기 링 버퍼 뱀 몸통
+// 몸통 칸을 칸 번호(y * width + x)로 연속 배열에 저장한다.
+// 용량은 보드 넓이 이상의 2의 거듭제곱이라 인덱스 계산은 마스크 한 번이면 되고,
+// 머리 추가/꼬리 제거 모두 할당 없이 O(1)이다. (할당은 reset() 에서 한 번만)
+
+#ifndef SNAKE_BODY_H
+#define SNAKE_BODY_H
+
+#include <cstdint>
+#include <vector>
+
+// 32 bits so boards up to 1024x1024 can be addressed
+typedef std::uint32_t CellIndex;
+
+constexpr int ceilPowerOfTwo(int n) {
+    int p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+struct SnakeBody {
+    std::vector<CellIndex> cells;
+    unsigned               mask  = 0;
+    unsigned               head  = 0; // Slot of the head segment
+    int                    count = 0;
+
+    // Sizes the ring for a board of `maxCells` cells and empties it.
+    void reset(int maxCells) {
+        int capacity = ceilPowerOfTwo(maxCells);
+        if ((int)cells.size() != capacity)
+            cells.assign(capacity, 0);
+        mask = capacity - 1;
+        clear();
+    }
+
+    void clear() {
+        head  = 0;
+        count = 0;
+    }
+
+    int  size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // i = 0 is the head, i = size() - 1 the tail
+    CellIndex at(int i) const { return cells[(head + i) & mask]; }
+    CellIndex front() const { return cells[head]; }
+    CellIndex back() const { return cells[(head + count - 1) & mask]; }
+
+    void pushFront(CellIndex cell) {
+        head        = (head - 1) & mask;
+        cells[head] = cell;
+        ++count;
+    }
+
+    void pushBack(CellIndex cell) {
+        cells[(head + count) & mask] = cell;
+        ++count;
+    }
+
+    void popBack() { --count; }
+
+    // Visits head to tail as at most two contiguous runs.
+    template <typename Fn> void forEach(Fn fn) const {
+        int capacity = (int)mask + 1;
+        int firstRun = count < capacity - (int)head ? count : capacity - (int)head;
+        for (int i = 0; i < firstRun; ++i)
+            fn(cells[head + i]);
+        for (int i = 0; i < count - firstRun; ++i)
+            fn(cells[i]);
+    }
+};
+
+#endif
@@ -0,0 +1,636 @@
+// snake_engine.cpp - 게임 규칙 (ncurses 의존성 없음)
+
+#include "snake_engine.h"
+
+#include "map_generator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+// --- Stage tables ---
+const GameRules defaultRules = {
+    {LAYOUT_SCATTER, LAYOUT_SCATTER, LAYOUT_SCATTER, LAYOUT_SCATTER}, // layoutPerStage
+    {1.5, 2.5, 3.5, 4.5},  // innerWallProbability
+    {100, 75, 50, 40},     // gateRespawnIntervalPerStage
+    {500, 400, 300, 250},  // stageTurnLimitPerStage
+    {6, 9, 12, 15},        // mission_length_per_stage
+    {5, 7, 9, 11},         // mission_growth_per_stage
+    {2, 4, 6, 8},          // mission_poison_per_stage
+    {2, 3, 4, 5},          // mission_gate_per_stage
+    3,                     // maxGrowthItems
+    3,                     // maxPoisonItems
+    ITEM_LIFESPAN,         // itemLifespan
+};
+const int delay_per_stage[STAGES] = {220000, 180000, 120000, 60000};
+
+static const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4] = {0, 0, -1, 1};
+
+static int spawnItem(GameState &state, int itemType);
+
+// --- Board geometry for the tick kernels ---
+// FixedGeometry turns the bounds of the common board sizes into constants, so the 21x21 kernel
+// compiles to the same code as the old #define HEIGHT/WIDTH build. Any other size uses
+// DynamicGeometry, which reads them from the state.
+template <int H, int W> struct FixedGeometry {
+    static int height(const GameState &) { return H; }
+    static int width(const GameState &) { return W; }
+};
+
+struct DynamicGeometry {
+    static int height(const GameState &state) { return state.height; }
+    static int width(const GameState &state) { return state.width; }
+};
+
+// True if some in-bounds neighbour of `cell` satisfies `pred(value)`.
+template <typename Pred> static bool anyNeighbour(const GameState &state, int cell, Pred pred) {
+    const int W = state.width;
+    int       y = cell / W, x = cell % W;
+    for (int d = 0; d < 4; ++d) {
+        int ny = y + dy[d], nx = x + dx[d];
+        if (ny >= 0 && ny < state.height && nx >= 0 && nx < W && pred(state.map[ny * W + nx]))
+            return true;
+    }
+    return false;
+}
+
+// Floor (anything but a wall or gate) stays floor for the whole stage, so whether a wall is
+// next to floor only changes when the layout is rebuilt.
+static bool besideFloor(const GameState &state, int cell) {
+    return anyNeighbour(state, cell, [](int value) {
+        return value != CELL_WALL && value != CELL_IMMUNE_WALL && value != CELL_GATE;
+    });
+}
+
+static bool besideEmpty(const GameState &state, int cell) {
+    return anyNeighbour(state, cell, [](int value) { return value == CELL_EMPTY; });
+}
+
+void setCell(GameState &state, int cell, int value) {
+    int old = state.map[cell];
+    if (old == value)
+        return;
+
+    if (old == CELL_EMPTY)
+        state.freeCells.erase(cell);
+    else if (value == CELL_EMPTY)
+        state.freeCells.insert(cell);
+
+    if (old == CELL_GROWTH)
+        state.growthItemCount--;
+    else if (old == CELL_POISON)
+        state.poisonItemCount--;
+    if (value == CELL_GROWTH)
+        state.growthItemCount++;
+    else if (value == CELL_POISON)
+        state.poisonItemCount++;
+
+    state.map[cell] = value;
+    if (old == CELL_WALL)
+        state.gateCandidates.erase(cell);
+    else if (value == CELL_WALL && besideFloor(state, cell))
+        state.gateCandidates.insert(cell);
+    markDirty(state, cell);
+}
+
+void markDirty(GameState &state, int cell) {
+    if (state.dirtyFlag[cell])
+        return;
+    state.dirtyFlag[cell]                = 1;
+    state.dirtyCells[state.dirtyCount++] = (CellIndex)cell;
+}
+
+void clearDamage(GameState &state) {
+    for (int i = 0; i < state.dirtyCount; ++i)
+        state.dirtyFlag[state.dirtyCells[i]] = 0;
+    state.dirtyCount = 0;
+    state.fullRedraw = false;
+}
+
+void rebuildCellIndex(GameState &state) {
+    state.freeCells.clear();
+    state.growthItemCount = 0;
+    state.poisonItemCount = 0;
+    int area = state.height * state.width;
+    for (int cell = 0; cell < area; ++cell) {
+        int value = state.map[cell];
+        if (value == CELL_EMPTY)
+            state.freeCells.insert(cell);
+        else if (value == CELL_GROWTH)
+            state.growthItemCount++;
+        else if (value == CELL_POISON)
+            state.poisonItemCount++;
+    }
+
+    state.gateCandidates.clear();
+    for (int cell = 0; cell < area; ++cell)
+        if (state.map[cell] == CELL_WALL && besideFloor(state, cell))
+            state.gateCandidates.insert(cell);
+}
+
+bool parseBoardSize(const char *text, int &height, int &width) {
+    int h, w;
+    if (sscanf(text, "%dx%d", &h, &w) != 2)
+        return false;
+    if (h < MIN_BOARD_SIZE || h > MAX_BOARD_SIZE || w < MIN_BOARD_SIZE || w > MAX_BOARD_SIZE)
+        return false;
+    height = h;
+    width  = w;
+    return true;
+}
+
+void resetBoard(GameState &state, int height, int width, const GameRules &rules) {
+    // Carry the board-sized buffers over so a restart doesn't reallocate them
+    GameState fresh;
+    fresh.map.swap(state.map);
+    fresh.freeCells.words.swap(state.freeCells.words);
+    fresh.freeCells.tree.swap(state.freeCells.tree);
+    fresh.gateCandidates.words.swap(state.gateCandidates.words);
+    fresh.gateCandidates.tree.swap(state.gateCandidates.tree);
+    fresh.snake.cells.swap(state.snake.cells);
+    fresh.dirtyCells.swap(state.dirtyCells);
+    fresh.dirtyFlag.swap(state.dirtyFlag);
+    state        = std::move(fresh);
+    state.height = height;
+    state.width  = width;
+    state.rules  = &rules;
+
+    int area = height * width;
+    state.map.assign(area, CELL_EMPTY);
+    state.freeCells.reset(area);
+    state.gateCandidates.reset(area);
+    state.snake.reset(area);
+    state.dirtyCells.resize(area);
+    state.dirtyFlag.assign(area, 0);
+}
+
+void initGame(GameState &state, unsigned seed, int height, int width,
+              const GameRules &rules) {
+    resetBoard(state, height, width, rules);
+    state.rng.seed(seed);
+    initStage(state, 0);
+}
+
+void updateDirection(GameState &state, int newDir) {
+    if (newDir < UP || newDir > RIGHT)
+        return;
+
+    int  dirIndex = state.dirIndex;
+    bool isUturn  = (dirIndex == UP && newDir == DOWN) || (dirIndex == DOWN && newDir == UP) ||
+                   (dirIndex == LEFT && newDir == RIGHT) || (dirIndex == RIGHT && newDir == LEFT);
+
+    if (isUturn) {
+        state.gameOverReason = 1; // U-턴으로 인한 게임 오버 이유 설정
+    }
+
+    if (newDir != dirIndex && !isUturn) { // Only change direction if not a U-turn
+        state.prevDirIndex = dirIndex;
+        state.dirIndex     = newDir;
+    }
+}
+
+template <typename Geometry>
+static int exitDirectionImpl(const GameState &state, int exitGateY, int exitGateX,
+                             int entryDirection) {
+    const int H    = Geometry::height(state);
+    const int W    = Geometry::width(state);
+    const auto &map = state.map;
+    bool isWall    = map[exitGateY * W + exitGateX] == CELL_WALL;
+
+    // Rule 1: Gate at map edge (border wall)
+    if (exitGateY == 0 && isWall)
+        return DOWN; // Top border -> Down
+    if (exitGateY == H - 1 && isWall)
+        return UP; // Bottom border -> Up
+    if (exitGateX == 0 && isWall)
+        return RIGHT; // Left border -> Right
+    if (exitGateX == W - 1 && isWall)
+        return LEFT; // Right border -> Left
+
+    // Rule 2: Gate in the middle of the map (not edge)
+    int clockwise[4]        = {3, 2, 0, 1}; // UP->RIGHT, DOWN->LEFT, LEFT->UP, RIGHT->DOWN
+    int counterClockwise[4] = {2, 3, 1, 0}; // UP->LEFT, DOWN->RIGHT, LEFT->DOWN, RIGHT->UP
+    int opposite[4]         = {1, 0, 3, 2}; // UP->DOWN, DOWN->UP, LEFT->RIGHT, RIGHT->LEFT
+
+    const int order[4] = {
+        entryDirection,                   // Priority 1: Same as entry direction
+        clockwise[entryDirection],        // Priority 2: Clockwise rotation
+        counterClockwise[entryDirection], // Priority 3: Counter-clockwise rotation
+        opposite[entryDirection],         // Priority 4: Opposite direction
+    };
+    for (int d : order) {
+        int nextY = exitGateY + dy[d];
+        int nextX = exitGateX + dx[d];
+        if (nextY < 0 || nextY >= H || nextX < 0 || nextX >= W)
+            continue;
+        int next = map[nextY * W + nextX];
+        if (next == CELL_EMPTY || next == CELL_GROWTH || next == CELL_POISON)
+            return d;
+    }
+    return entryDirection; // Last resort: stick to entry if all else fails
+}
+
+// Bit d set if the neighbour of `gate` in direction d is on the board and can be moved into;
+// the exit rules look at nothing else around an exit gate.
+template <typename Geometry> static int gateOpenings(const GameState &state, int gate) {
+    const int H    = Geometry::height(state);
+    const int W    = Geometry::width(state);
+    int       y    = gate / W, x = gate % W;
+    int       open = 0;
+    for (int d = 0; d < 4; ++d) {
+        int ny = y + dy[d], nx = x + dx[d];
+        if (ny < 0 || ny >= H || nx < 0 || nx >= W)
+            continue;
+        int next = state.map[ny * W + nx];
+        if (next == CELL_EMPTY || next == CELL_GROWTH || next == CELL_POISON)
+            open |= 1 << d;
+    }
+    return open;
+}
+
+template <typename Geometry>
+static void buildGateExits(const GameState &state, GateExits &exits, int open) {
+    const int H = Geometry::height(state);
+    const int W = Geometry::width(state);
+    int       y = exits.cell / W, x = exits.cell % W;
+    for (int entry = 0; entry < 4; ++entry) {
+        int d  = exitDirectionImpl<Geometry>(state, y, x, entry);
+        int ny = y + dy[d], nx = x + dx[d];
+        exits.dir[entry]  = d;
+        exits.exit[entry] = (ny < 0 || ny >= H || nx < 0 || nx >= W) ? -1 : ny * W + nx;
+    }
+    exits.open = open;
+}
+
+// Exit cell for a head entering `gate`, or -1 when the exit leads off the board. Looks the
+// other gate's exit up in its table, rebuilt only when one of its neighbours has changed.
+template <typename Geometry>
+static int teleportThroughGate(GameState &state, int gate, int entryDirection) {
+    GateExits &exits = state.gateExits[gate == state.gateExits[0].cell ? 1 : 0];
+    int        open  = gateOpenings<Geometry>(state, exits.cell);
+    if (open != exits.open)
+        buildGateExits<Geometry>(state, exits, open);
+
+    // The head lands *outside* the exit gate, in the new direction of travel
+    state.dirIndex = exits.dir[entryDirection];
+    return exits.exit[entryDirection];
+}
+
+static void advanceTimers(GameState &state) {
+    state.timers.advance([&state](int id, int kind, int payload) {
+        switch (kind) {
+        case TIMER_ITEM_EXPIRE: {
+            // Expired items move elsewhere: drop it and spawn one of the same type
+            int type = state.map[payload];
+            for (int i = 0; i < state.itemCount; ++i) {
+                if (state.items[i].timer == id) {
+                    state.items[i] = state.items[--state.itemCount];
+                    break;
+                }
+            }
+            // Eating cancels the timer, so this only guards the board against a stale one
+            if (type != CELL_GROWTH && type != CELL_POISON)
+                break;
+            setCell(state, payload, CELL_EMPTY);
+            spawnItem(state, type);
+            break;
+        }
+        case TIMER_GATE_RESPAWN:
+            state.gateTimer = -1;
+            spawnGates(state);
+            break;
+        case TIMER_GATE_COOLDOWN:
+            state.gateCooldownTimer = -1;
+            break;
+        }
+    });
+}
+
+template <typename Geometry> static void moveSnakeImpl(GameState &state) {
+    const int H     = Geometry::height(state);
+    const int W     = Geometry::width(state);
+    auto     &map   = state.map;
+    auto     &snake = state.snake;
+
+    int ny = state.headY + dy[state.dirIndex];
+    int nx = state.headX + dx[state.dirIndex];
+
+    // Item expiry, gate respawn and gate cooldown
+    advanceTimers(state);
+
+    // Boundary collision
+    if (ny < 0 || ny >= H || nx < 0 || nx >= W) {
+        state.gameOverReason = 2;
+        return;
+    }
+
+    int tgt = map[ny * W + nx];
+    // Wall or self collision
+    if (tgt == CELL_WALL || tgt == CELL_IMMUNE_WALL || tgt == CELL_SNAKE) {
+        state.gameOverReason = (tgt == CELL_SNAKE ? 3 : 2);
+        return;
+    }
+
+    if (tgt == CELL_GATE) {
+        if (gateOnCooldown(state)) {
+            state.gameOverReason = 6;
+            return;
+        }
+        state.gates_used_count++;
+        state.total_score_gate += 20;
+        int exit = teleportThroughGate<Geometry>(state, ny * W + nx, state.dirIndex);
+        if (exit < 0) {
+            state.gameOverReason = 2;
+            return;
+        }
+        ny  = exit / W;
+        nx  = exit % W;
+        tgt = map[exit];
+        // The exit rules fall back to the entry direction when nothing around the gate is open
+        if (tgt == CELL_WALL || tgt == CELL_IMMUNE_WALL || tgt == CELL_GATE || tgt == CELL_SNAKE) {
+            state.gameOverReason = (tgt == CELL_SNAKE ? 3 : 2);
+            return;
+        }
+        state.gateCooldownTimer =
+            state.timers.schedule(GATE_COOLDOWN_TICKS, TIMER_GATE_COOLDOWN, 0);
+    }
+
+    // An item is eaten the same way whether the head walked onto it or came out of a gate
+    bool grew = false;
+
+    if (tgt == CELL_GROWTH) {
+        state.collected_growth_items++;
+        state.total_score_growth += 10;
+        grew = true; // skip tail removal
+        removeItem(state, ny * W + nx);
+    } else if (tgt == CELL_POISON) {
+        state.collected_poison_items++;
+        state.total_score_poison -= 5;
+        if (!snake.empty()) {
+            setCell(state, snake.back(), CELL_EMPTY);
+            snake.popBack(); // remove exactly 1 segment
+            if (snake.size() < 3) {
+                state.gameOverReason = 5;
+                return;
+            }
+        }
+        removeItem(state, ny * W + nx);
+    }
+
+    // Normal move tail removal
+    if (!grew && !snake.empty()) {
+        setCell(state, snake.back(), CELL_EMPTY);
+        snake.popBack();
+    }
+
+    // Advance head (the old head cell now draws as body)
+    markDirty(state, state.headY * W + state.headX);
+    state.headY = ny;
+    state.headX = nx;
+    snake.pushFront((CellIndex)(ny * W + nx));
+    setCell(state, ny * W + nx, CELL_SNAKE);
+
+    // Replace the eaten item only after the head has claimed its cell
+    if (tgt == CELL_GROWTH)
+        spawnGrowthItem(state);
+    else if (tgt == CELL_POISON)
+        spawnPoisonItem(state);
+
+    // Turn counter & limits
+    if (++state.stageTurnCounter > state.rules->stageTurnLimitPerStage[state.currentStage]) {
+        state.gameOverReason = 4;
+        return;
+    }
+
+    // Track max length
+    state.maxLengthAchieved = std::max(state.maxLengthAchieved, snake.size());
+
+    state.prevDirIndex = state.dirIndex;
+}
+
+void moveSnake(GameState &state) {
+    if (state.height == 21 && state.width == 21)
+        moveSnakeImpl<FixedGeometry<21, 21>>(state);
+    else if (state.height == 41 && state.width == 41)
+        moveSnakeImpl<FixedGeometry<41, 41>>(state);
+    else if (state.height == 81 && state.width == 81)
+        moveSnakeImpl<FixedGeometry<81, 81>>(state);
+    else
+        moveSnakeImpl<DynamicGeometry>(state);
+}
+
+int calculateExitDirection(const GameState &state, int exitGateY, int exitGateX,
+                           int entryDirection) {
+    return exitDirectionImpl<DynamicGeometry>(state, exitGateY, exitGateX, entryDirection);
+}
+
+// Places an item on a uniformly chosen empty cell.
+static int spawnItem(GameState &state, int itemType) {
+    if (state.freeCells.empty() || state.itemCount == MAX_LIVE_ITEMS)
+        return -1; // Board is full
+    int cell = state.freeCells.at(state.rng.below(state.freeCells.size()));
+    setCell(state, cell, itemType);
+
+    // Each item gets its own lifespan
+    GameState::LiveItem &item = state.items[state.itemCount++];
+    item.cell                 = cell;
+    item.timer = state.timers.schedule(state.rules->itemLifespan, TIMER_ITEM_EXPIRE, cell);
+    return cell;
+}
+
+void removeItem(GameState &state, int cell) {
+    for (int i = 0; i < state.itemCount; ++i) {
+        if (state.items[i].cell != cell)
+            continue;
+        state.timers.cancel(state.items[i].timer);
+        state.items[i] = state.items[--state.itemCount];
+        break;
+    }
+    setCell(state, cell, CELL_EMPTY);
+}
+
+int spawnGrowthItem(GameState &state) {
+    if (state.growthItemCount >= state.rules->maxGrowthItems)
+        return -1;
+    return spawnItem(state, CELL_GROWTH);
+}
+
+int spawnPoisonItem(GameState &state) {
+    if (state.poisonItemCount >= state.rules->maxPoisonItems)
+        return -1;
+    return spawnItem(state, CELL_POISON);
+}
+
+// A uniform pick among gateCandidates other than `skip` that have an empty cell to exit into.
+// Rejection sampling is cheap unless the snake and items crowd most candidates; after
+// GATE_PICK_TRIES misses it counts the usable ones instead. -1 when there are none.
+static int pickGateCandidate(GameState &state, int skip) {
+    const FreeCellSet &candidates = state.gateCandidates;
+    int                skipRank   = skip < 0 ? candidates.size() : candidates.rank(skip);
+    int                count      = candidates.size() - (skip < 0 ? 0 : 1);
+    if (count <= 0)
+        return -1;
+    for (int tries = 0; tries < GATE_PICK_TRIES; ++tries) {
+        int i    = state.rng.below(count);
+        int cell = candidates.at(i >= skipRank ? i + 1 : i);
+        if (besideEmpty(state, cell))
+            return cell;
+    }
+
+    int usable = 0;
+    candidates.forEach([&](int cell) { usable += cell != skip && besideEmpty(state, cell); });
+    if (usable == 0)
+        return -1;
+    int pick = state.rng.below(usable), picked = -1;
+    candidates.forEach([&](int cell) {
+        if (cell != skip && besideEmpty(state, cell) && pick-- == 0)
+            picked = cell;
+    });
+    return picked;
+}
+
+void spawnGates(GameState &state) {
+    const int W     = state.width;
+    auto     &gateA = state.gateA;
+    auto     &gateB = state.gateB;
+
+    // Clear old gates first
+    if (gateA.first != -1)
+        setCell(state, gateA.first * W + gateA.second, CELL_WALL); // Revert to wall
+    if (gateB.first != -1)
+        setCell(state, gateB.first * W + gateB.second, CELL_WALL); // Revert to wall
+    gateA              = {-1, -1};
+    gateB              = {-1, -1};
+    state.gateExits[0] = GateExits{};
+    state.gateExits[1] = GateExits{};
+
+    int cellA = pickGateCandidate(state, -1);
+    int cellB = cellA < 0 ? -1 : pickGateCandidate(state, cellA);
+    if (cellB < 0)
+        return; // Not enough walls to form a pair of gates
+
+    gateA              = {cellA / W, cellA % W};
+    gateB              = {cellB / W, cellB % W};
+    state.gateExits[0] = GateExits{cellA};
+    state.gateExits[1] = GateExits{cellB};
+
+    setCell(state, cellA, CELL_GATE);
+    setCell(state, cellB, CELL_GATE);
+
+    // The pair regenerates after the stage's gate lifespan
+    state.timers.cancel(state.gateTimer);
+    state.gateTimer =
+        state.timers.schedule(state.rules->gateRespawnIntervalPerStage[state.currentStage],
+                              TIMER_GATE_RESPAWN, 0);
+}
+
+void initStage(GameState &state, int stage) {
+    const int H   = state.height;
+    const int W   = state.width;
+    auto     &map = state.map;
+
+    state.snake.clear();
+    state.stageTurnCounter  = 0;
+    state.gateA             = {-1, -1};
+    state.gateB             = {-1, -1};
+    state.gateExits[0]      = GateExits{};
+    state.gateExits[1]      = GateExits{};
+    state.itemCount         = 0;
+    state.gateTimer         = -1;
+    state.gateCooldownTimer = -1;
+    state.timers.clear();
+    clearDamage(state);
+    state.fullRedraw = true;
+
+    // Border and inner walls, every empty cell reachable from the start
+    generateLayout(state, stage);
+
+    // Center start: head + 2 body segments to its left
+    int headY   = H / 2;
+    int headX   = W / 2;
+    state.headY = headY;
+    state.headX = headX;
+    state.snake.pushBack((CellIndex)(headY * W + headX));     // head
+    state.snake.pushBack((CellIndex)(headY * W + headX - 1)); // body 1
+    state.snake.pushBack((CellIndex)(headY * W + headX - 2)); // body 2
+    state.snake.forEach([&map](CellIndex cell) { map[cell] = CELL_SNAKE; });
+    rebuildCellIndex(state);
+
+    state.dirIndex     = RIGHT;
+    state.prevDirIndex = RIGHT;
+
+    // Spawn first items/gates
+    spawnGrowthItem(state);
+    spawnPoisonItem(state);
+    spawnGates(state);
+}
+
+// This function checks if all mission objectives for the current stage are met.
+bool checkMissionClear(const GameState &state) {
+    const GameRules &rules       = *state.rules;
+    int              stageIdx    = state.currentStage;
+    bool             lengthClear = (state.snake.size() >= rules.mission_length_per_stage[stageIdx]);
+    bool growthClear = (state.collected_growth_items >= rules.mission_growth_per_stage[stageIdx]);
+    bool poisonClear = (state.collected_poison_items >= rules.mission_poison_per_stage[stageIdx]);
+    bool gateClear   = (state.gates_used_count >= rules.mission_gate_per_stage[stageIdx]);
+
+    return lengthClear && growthClear && poisonClear && gateClear;
+}
+
+StepResult step(GameState &state, int input) {
+    if (state.gameOver)
+        return state.gameWon ? STEP_GAME_WON : STEP_GAME_OVER;
+
+    updateDirection(state, input);
+    moveSnake(state);
+
+    if (state.gameOverReason != 0 || state.snake.size() < 3) {
+        state.gameOver = true;
+        return STEP_GAME_OVER;
+    }
+
+    if (checkMissionClear(state)) {
+        state.currentStage++;
+        if (state.currentStage >= STAGES) {
+            state.gameOver = true;
+            state.gameWon  = true;
+            return STEP_GAME_WON;
+        }
+        // Reset stage progress before initializing
+        state.collected_growth_items = 0;
+        state.collected_poison_items = 0;
+        state.gates_used_count       = 0;
+        initStage(state, state.currentStage);
+        return STEP_STAGE_CLEAR;
+    }
+    return STEP_CONTINUE;
+}
+
+int itemTicksLeft(const GameState &state) {
+    long long best = -1;
+    for (int i = 0; i < state.itemCount; ++i) {
+        long long left = state.timers.remaining(state.items[i].timer);
+        if (best < 0 || left < best)
+            best = left;
+    }
+    return (int)best;
+}
+
+int gateTicksLeft(const GameState &state) {
+    if (!state.timers.active(state.gateTimer))
+        return -1;
+    return (int)state.timers.remaining(state.gateTimer);
+}
+
+bool gateOnCooldown(const GameState &state) { return state.timers.active(state.gateCooldownTimer); }
+
+int currentScore(const GameState &state) {
+    return state.total_score_growth + state.total_score_poison + state.total_score_gate;
+}
+
+int finalScore(const GameState &state) {
+    return state.snake.size() * 100 + state.total_score_growth - state.total_score_poison +
+           state.total_score_gate;
+}
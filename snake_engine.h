@@ -0,0 +1,219 @@
+// snake_engine.h - ncurses 없이 동작하는 게임 엔진
+// GameState 하나가 한 판의 모든 상태를 들고 있고, step()이 한 틱을 진행한다.
+// snake_game(ncurses UI)과 snake_headless(시뮬레이션) 양쪽에서 사용한다.
+
+#ifndef SNAKE_ENGINE_H
+#define SNAKE_ENGINE_H
+
+#include "free_cell_set.h"
+#include "game_rng.h"
+#include "snake_body.h"
+#include "timing_wheel.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define DEFAULT_HEIGHT 21 // Classic board, also a specialized tick kernel
+#define DEFAULT_WIDTH 21
+#define MIN_BOARD_SIZE 7
+#define MAX_BOARD_SIZE 1024
+#define ITEM_LIFESPAN 300
+#define IMMUNE_WALL 9
+#define STAGES 4
+#define GATE_COOLDOWN_TICKS 5 // Cooldown after using a gate (in ticks)
+#define MAX_LIVE_ITEMS 16     // Upper bound on items on the board at once
+#define MAX_TIMERS (MAX_LIVE_ITEMS + 2)
+#define GATE_PICK_TRIES 32 // Candidates drawn for a gate before counting the usable ones
+
+enum Direction { UP = 0, DOWN, LEFT, RIGHT };
+
+#define NO_INPUT -1 // step() input when no direction key was pressed this tick
+
+// Map cell values
+enum CellType {
+    CELL_EMPTY       = 0,
+    CELL_WALL        = 1,
+    CELL_POISON      = 2,
+    CELL_SNAKE       = 3,
+    CELL_GROWTH      = 4,
+    CELL_GATE        = 5,
+    CELL_IMMUNE_WALL = IMMUNE_WALL,
+};
+
+// Timer kinds scheduled on GameState::timers
+enum TimerKind {
+    TIMER_ITEM_EXPIRE = 0, // payload: cell index of the item
+    TIMER_GATE_RESPAWN,    // current gate pair reached its lifespan
+    TIMER_GATE_COOLDOWN,   // gates usable again
+};
+
+// step() result
+enum StepResult {
+    STEP_CONTINUE = 0, // Normal tick
+    STEP_STAGE_CLEAR,  // Mission cleared, next stage already initialized
+    STEP_GAME_OVER,    // gameOverReason holds the cause
+    STEP_GAME_WON,     // All stages cleared
+};
+
+// Inner wall layouts built by generateLayout() (map_generator.h)
+enum LayoutKind {
+    LAYOUT_SCATTER = 0, // Walls scattered with innerWallProbability
+    LAYOUT_MAZE,        // Braided maze
+    LAYOUT_ROOMS,       // Rooms joined by doors, scattered inside
+};
+
+// --- Stage tables ---
+// Everything stage balance is tuned with. A game reads them through GameState::rules so the
+// balance simulator can try other values side by side; the game itself uses defaultRules.
+struct GameRules {
+    int    layoutPerStage[STAGES];       // LayoutKind
+    double innerWallProbability[STAGES]; // Percent of inner cells that start as walls
+    int    gateRespawnIntervalPerStage[STAGES];
+    int    stageTurnLimitPerStage[STAGES];
+    int    mission_length_per_stage[STAGES];
+    int    mission_growth_per_stage[STAGES];
+    int    mission_poison_per_stage[STAGES];
+    int    mission_gate_per_stage[STAGES];
+    int    maxGrowthItems; // spawned concurrently; the two caps add up to <= MAX_LIVE_ITEMS
+    int    maxPoisonItems;
+    int    itemLifespan; // Ticks before an uneaten item moves
+};
+
+extern const GameRules defaultRules;
+extern const int       delay_per_stage[STAGES]; // UI pace, not part of the rules
+
+// Where a head entering the other gate comes out of this one, for each entry direction. Built
+// on first use and rebuilt only when the neighbours it was built from (`open`) have changed.
+struct GateExits {
+    int cell = -1;    // y * width + x of the gate
+    int open = -1;    // gateOpenings() bits the table was built for, -1 before the first build
+    int dir[4]  = {}; // Exit direction by entry direction
+    int exit[4] = {}; // Cell the head lands on by entry direction, -1 if off the board
+};
+
+struct GameState {
+    // --- Game State ---
+    bool gameOver       = false;
+    int  gameOverReason = 0; // 0: no reason, 1: U-turn, 2: wall, 3: self-collision, 4: score-out,
+                             // 5: length<3, 6: gate cooldown, 7: quit
+    bool gameWon        = false;
+    int  currentStage   = 0;     // 0-indexed
+    bool autopilotUsed  = false; // Set by the front end; such games are not ranked
+
+    // --- Board geometry (fixed for the whole game) ---
+    int height = DEFAULT_HEIGHT;
+    int width  = DEFAULT_WIDTH;
+
+    // --- Snake (front = head, cells are y * width + x) ---
+    SnakeBody snake;
+    int       headY = 0, headX = 0;
+    int       dirIndex     = RIGHT;
+    int       prevDirIndex = RIGHT;
+
+    // --- Map (row-major CellType values), items and gates ---
+    std::vector<std::uint8_t> map;
+    std::pair<int, int>       gateA = {-1, -1};
+    std::pair<int, int>       gateB = {-1, -1};
+    GateExits                 gateExits[2]; // For gateA and gateB
+
+    // --- Timers (item lifespans, gate respawn and cooldown) ---
+    struct LiveItem {
+        int cell;  // y * width + x
+        int timer; // TIMER_ITEM_EXPIRE id
+    };
+    TimingWheel<MAX_TIMERS> timers;
+    LiveItem                items[MAX_LIVE_ITEMS];
+    int                     itemCount         = 0;
+    int                     gateTimer         = -1; // TIMER_GATE_RESPAWN id
+    int                     gateCooldownTimer = -1; // Active while gates can't be entered
+
+    // Index of CELL_EMPTY cells and live item counts, kept current by setCell()
+    FreeCellSet freeCells;
+    int         growthItemCount = 0;
+    int         poisonItemCount = 0;
+
+    // Gate candidates: CELL_WALL cells next to floor (a cell that isn't a wall or gate),
+    // rebuilt with the layout and kept current by setCell() as gates open and revert
+    FreeCellSet gateCandidates;
+
+    // --- Damage list for renderers: cells changed since the last clearDamage() ---
+    std::vector<CellIndex>    dirtyCells;
+    std::vector<std::uint8_t> dirtyFlag;
+    int                       dirtyCount = 0;
+    bool                      fullRedraw = true; // Whole board changed (new stage)
+
+    // --- Mission progress (current stage) ---
+    int collected_growth_items = 0;
+    int collected_poison_items = 0;
+    int gates_used_count       = 0;
+    int stageTurnCounter       = 0;
+
+    // --- Scores (whole game) ---
+    int total_score_growth = 0;
+    int total_score_poison = 0;
+    int total_score_gate   = 0;
+    int maxLengthAchieved  = 3;
+
+    GameRng          rng; // The only source of randomness: same seed + inputs, same game
+    const GameRules *rules = &defaultRules; // Set by initGame(), never null
+};
+
+inline int cellAt(const GameState &state, int y, int x) { return state.map[y * state.width + x]; }
+
+// Parses "HEIGHTxWIDTH" (e.g. "41x41") within MIN_BOARD_SIZE..MAX_BOARD_SIZE.
+bool parseBoardSize(const char *text, int &height, int &width);
+
+// Resets every field, sizes the board and starts stage 0 under `rules`, which must outlive
+// the game. Boards 21x21, 41x41 and 81x81 tick through kernels with compile-time bounds.
+void initGame(GameState &state, unsigned seed, int height = DEFAULT_HEIGHT,
+              int width = DEFAULT_WIDTH, const GameRules &rules = defaultRules);
+void initStage(GameState &state, int stage);
+// initGame() without the seed and the stage: every field reset and the board sized but empty.
+// For filling a state in from elsewhere, e.g. loadSnapshot().
+void resetBoard(GameState &state, int height, int width, const GameRules &rules = defaultRules);
+
+// Applies a direction input. A U-turn is not applied and sets gameOverReason = 1.
+void updateDirection(GameState &state, int newDir);
+void moveSnake(GameState &state);
+bool checkMissionClear(const GameState &state);
+
+// One full tick: direction input, movement, game-over check and stage advancement.
+StepResult step(GameState &state, int input);
+
+// Every map write after initStage() goes through setCell() so the free-cell index and
+// item counters stay in sync with the board.
+void setCell(GameState &state, int cell, int value);
+void rebuildCellIndex(GameState &state);
+
+// Renderers redraw dirtyCells[0..dirtyCount) (or everything when fullRedraw is set), then
+// call clearDamage(). Cells are listed once no matter how many ticks passed in between.
+void markDirty(GameState &state, int cell);
+void clearDamage(GameState &state);
+
+// Spawns are O(log area): a uniform pick by rank from the free-cell index, so the cell depends
+// only on which cells are free and the RNG.
+// Returns the cell index (y * width + x) or -1 when at the item cap or the board is full.
+int spawnGrowthItem(GameState &state);
+int spawnPoisonItem(GameState &state);
+
+// Reverts the current gates to walls and opens a new pair: two distinct gateCandidates with an
+// empty cell to exit into, picked uniformly in O(log area) expected time. No gates if there's
+// no pair.
+void spawnGates(GameState &state);
+int  calculateExitDirection(const GameState &state, int exitGateY, int exitGateX,
+                            int entryDirection);
+
+// Removes an item and cancels its expiry timer.
+void removeItem(GameState &state, int cell);
+
+// Ticks until the next item expires / the gates regenerate; -1 if there is none.
+int  itemTicksLeft(const GameState &state);
+int  gateTicksLeft(const GameState &state);
+bool gateOnCooldown(const GameState &state);
+
+// The HUD's "Current Score": item and gate points. finalScore() adds 100 per segment on top.
+int currentScore(const GameState &state);
+int finalScore(const GameState &state);
+
+#endif
@@ -1,40 +1,40 @@
-// snake_game.cpp - 최종 통합 버전
-// Compile: clang++ -std=c++17 -g snake_game.cpp -o snake_game -lncurses
-// Run: ./snake_game
-
-#include <algorithm> // for std::sort
+// snake_game.cpp - 최종 통합 버전 (ncurses UI)
+// 게임 규칙은 snake_engine.cpp 에 있다.
+// Compile: make
+// Run: ./snake_game [--board HxW] [--tick-stats] [--autopilot] [--profile] [--render ansi]
+//                   [--adaptive] [--broadcast [SOCKET]] [--resume [FILE]]
+
+#include "ansi_renderer.h"
+#include "autopilot.h"
+#include "broadcast.h"
+#include "curses_board.h"
+#include "input_thread.h"
+#include "leaderboard.h"
+#include "output_pacer.h"
+#include "replay.h"
+#include "shared_leaderboard.h"
+#include "snake_engine.h"
+#include "snapshot.h"
+#include "tick_profiler.h"
+#include "tick_scheduler.h"
+
+#include <algorithm> // for std::min
+#include <cstdarg>
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <deque>
+#include <fcntl.h>
 #include <fstream>
 #include <locale.h>
 #include <ncurses.h>
 #include <random>
 #include <string.h> // For strlen
 #include <string>
+#include <sys/ioctl.h>
 #include <unistd.h>
 #include <vector>
 
-#define HEIGHT 21
-#define WIDTH 21
-#define ITEM_LIFESPAN 300
-#define IMMUNE_WALL 9
-#define STAGES 4
-#define GATE_LIFESPAN_TICKS 100 // How long a gate remains active (in ticks)
-#define GATE_COOLDOWN_TICKS 5   // Cooldown after using a gate (in ticks)
-
-// PlayerInfo 구조체 정의
-struct PlayerInfo {
-    std::string name;
-    int         score;
-
-    // 랭킹 정렬을 위한 비교 연산자 (점수 내림차순)
-    bool operator>(const PlayerInfo &other) const { return score > other.score; }
-};
-
-void initStage(int stage);
-void initColors();
 void inputPlayerName();
 void loadHighScore();
 void saveHighScore(int score);
@@ -44,604 +44,157 @@ void showGameOverScreen(int finalScore);
 void drawScoreboard();
 void drawMissionBoard();
 void drawMap();
-bool checkMissionClear();
-void spawnGrowthItem();
-void spawnPoisonItem();
-void spawnGates();
-void moveSnake();
-void updateDirection(int ch);
 void playGame();
 void showRankingScreen();
 
-// --- Globals (ensure these are consistent with your original file) ---
-
-// --- Game State Variables ---
-bool gameOver       = false; // Set to true when game ends
-int  gameOverReason = 0; // 0: no reason, 1: U-turn, 2: wall, 3: self-collision, 4: score-out, 5:
-                         // length<3, 6: gate cooldown
-bool gameWon = false;    // Set to true when all stages are cleared
-
-int currentStage = 0; // Tracks the current stage (0-indexed)
-
-// Snake related variables
-std::deque<std::pair<int, int>> snake;            // The snake's body segments
-int                             headY, headX;     // Snake's head coordinates
-int                             dirIndex     = 3; // Initial direction (3: RIGHT)
-int                             prevDirIndex = 3; // Previous direction
-
-// Map and Item related
-int  map[HEIGHT][WIDTH];                  // The game map
-int  itemFrame           = ITEM_LIFESPAN; // Timer for items
-bool gateSpawned         = false;         // Flag to check if gates are on map
-int  gateLifetimeCounter = 0;             // Tracks gate lifespan
-int  gateEntryY = -1, gateEntryX = -1;    // Coordinates of the entry gate
-int  gateExitY = -1, gateExitX = -1;      // Coordinates of the exit gate
-
-double innerWallProbability[STAGES] = {1.5, 2.5, 3.5, 4.5};
-
-// --- Score & Mission Progress Variables ---
-int collected_growth_items = 0; // Number of growth items collected in current stage
-int collected_poison_items = 0; // Number of poison items collected in current stage
-int gates_used_count       = 0; // Number of gates used in current stage
-
-// Mission status flags for display
-bool missionStatusLength[STAGES] = {false};
-bool missionStatusGrowth[STAGES] = {false};
-bool missionStatusPoison[STAGES] = {false};
-bool missionStatusGate[STAGES]   = {false};
+// --- Globals ---
+GameState game; // The game in progress
 
-// Player scores (these are reset in main() already, but ensure they are global)
-int total_score_growth = 0;
-int total_score_poison = 0;
-int total_score_gate   = 0;
-int maxLengthAchieved  = 3;
+int boardHeight = DEFAULT_HEIGHT; // Board size for new games (--board HxW)
+int boardWidth  = DEFAULT_WIDTH;
 
-// Turn counter
-int stageTurnCounter = 0;
+TickJitterStats tickStats;              // Tick lateness across all games played
+TurnQueue       turnStats;              // Turn counters and input latency across all games
+long long       droppedKeys    = 0;     // Keys lost to a full input queue
+bool            printTickStats = false; // --tick-stats: print tickStats on exit
 
-int  length;
-int  direction;
-bool paused = false;
+// Time spent in each phase of every tick played; written to TICK_PROFILE_FILE on exit.
+// --profile or 't' during a game shows it next to the mission board.
+TickProfiler tickProfile;
+bool         profileOverlayOn = false;
 
-int DELAY = 300000;
+// --render ansi: the game screen is composed by AnsiRenderer and sent with one write() per
+// frame instead of ncurses' refresh(). Menus and the other screens stay on ncurses.
+bool         ansiBackend = false;
+AnsiRenderer ansiScreen;
 
-int mission_length = 6;
-int mission_growth = 5;
-int mission_poison = 2;
-int mission_gate   = 2;
+// --adaptive (with the ANSI backend): frames are skipped while the terminal can't keep up,
+// compact glyphs are used while that happens often, and the HUD is redrawn less often.
+bool        adaptiveOn = false;
+OutputPacer pacer;
 
-int growthItemSpawnInterval = 20;
-int poisonItemSpawnInterval = 35;
-int frameCounter            = 0;
+// --broadcast: games are streamed to snake_watch spectators on a Unix socket
+const char *broadcastPath = nullptr;
+Broadcaster broadcaster;
 
-int gateRespawnIntervalPerStage[STAGES] = {100, 75, 50, 40};    // Adjusted for STAGES
-int stageTurnLimitPerStage[STAGES]      = {500, 400, 300, 250}; // Adjusted for STAGES
+// --resume: the first game continues the one saved in a snapshot file (SAVE_FILE when 'q' quit
+// it, CHECKPOINT_FILE for the start of the last stage reached) instead of starting anew
+const char *resumePath    = nullptr;
+bool        resumePending = false; // `game` holds the loaded snapshot
 
-int gateRespawnInterval = 50;
+// --autopilot or 'a' during a game: the snake steers itself. Such games aren't ranked.
+Autopilot autopilot;
+bool      autopilotOn = false;
 
-int gateLifespan = 100;
-
-int mission_length_per_stage[STAGES] = {6, 9, 12, 15};
-int mission_growth_per_stage[STAGES] = {5, 7, 9, 11};
-int mission_poison_per_stage[STAGES] = {2, 4, 6, 8};
-int mission_gate_per_stage[STAGES]   = {2, 3, 4, 5};
-int delay_per_stage[STAGES]          = {220000, 180000, 120000, 60000};
-
-// These variables are unused but declared for consistency
-int currentGrowthItemsCollected = 0; // unused
-int currentPoisonItemsCollected = 0; // unused
-
-const int maxGrowthItems = 3; // spawned concurrently
-const int maxPoisonItems = 3;
+#define INPUT_CHECK_NS 5000000 // How often a waiting game loop looks at the key queue
+#define LAST_REPLAY_FILE "last_replay.snkr"
+#define TICK_PROFILE_FILE "tick_profile.txt"
 
 std::wstring playerName = L"";
 int          highScore  = 0;
 
-std::pair<int, int> gateA = {-1, -1};
-std::pair<int, int> gateB = {-1, -1};
-
-std::random_device rd;
-std::mt19937       gen(rd());
-
-enum Direction { UP = 0, DOWN, LEFT, RIGHT };
-
-void initialize_ncurses() {
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_YELLOW, COLOR_BLACK); // Snake head (original: COLOR_YELLOW)
-        init_pair(2, COLOR_RED, COLOR_BLACK);
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK); // For growth item and snake head
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);
-        init_pair(5, COLOR_WHITE, COLOR_BLACK);
-        init_pair(6, COLOR_CYAN, COLOR_BLACK);
-        init_pair(7, COLOR_MAGENTA, COLOR_BLACK);
-    }
-}
+long long lastRank        = -1; // Leaderboard rank of the last finished game
+long long rankedGameCount = 0;  // Leaderboard size after it
 
-void updateDirection(int ch) {
-    if (paused && ch == 'p') {
-        paused = false;
-        return;
-    }
-    if (ch == 'p') {
-        paused = true;
-        return;
-    }
+// Scores shared live with every game running in this directory
+SharedLeaderboard sharedBoard;
+bool              sharedBoardReady = false;
+std::uint32_t     lastSequence     = NO_SEQUENCE; // Shared record of the last finished game
 
-    int newDir = dirIndex;
-
-    switch (ch) {
-    case KEY_UP:
-        newDir = UP;
-        break;
-    case KEY_DOWN:
-        newDir = DOWN;
-        break;
-    case KEY_LEFT:
-        newDir = LEFT;
-        break;
-    case KEY_RIGHT:
-        newDir = RIGHT;
-        break;
-    }
+#define RANKING_REFRESH_MS 200 // How often the ranking screen checks for new scores
 
-    bool isUturn = false;
-    if ((dirIndex == UP && newDir == DOWN) || (dirIndex == DOWN && newDir == UP) ||
-        (dirIndex == LEFT && newDir == RIGHT) || (dirIndex == RIGHT && newDir == LEFT)) {
-        isUturn = true;
-    }
+std::random_device rd;
 
-    if (isUturn) {
-        gameOverReason = 1; // U-턴으로 인한 게임 오버 이유 설정
-    }
+// --- Incremental HUD ---
+// Each HUD row remembers the text last written to it; unchanged rows are skipped.
+#define HUD_ROWS 34
+std::string hudCache[HUD_ROWS];
+bool        screenNeedsRedraw = true; // Set after anything draws over the board
 
-    if (newDir != dirIndex && !isUturn) { // Only change direction if not a U-turn
-        prevDirIndex = dirIndex;
-        dirIndex     = newDir;
-    }
+void invalidateHud() {
+    for (int i = 0; i < HUD_ROWS; ++i)
+        hudCache[i].clear();
 }
 
-bool isBorderWall(int y, int x) {
-    return (y == 0 || y == HEIGHT - 1 || x == 0 || x == WIDTH - 1) && map[y][x] == 1;
-}
+void hudPrintw(int y, int x, const char *fmt, ...) {
+    char    line[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
 
-int calculateExitDirection(int exitGateY, int exitGateX, int entryDirection) {
-    int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
-    int dx[4] = {0, 0, -1, 1};
-
-    // Rule 1: Gate at map edge (border wall)
-    if (exitGateY == 0 && map[exitGateY][exitGateX] == 1)
-        return DOWN; // Top border -> Down
-    if (exitGateY == HEIGHT - 1 && map[exitGateY][exitGateX] == 1)
-        return UP; // Bottom border -> Up
-    if (exitGateX == 0 && map[exitGateY][exitGateX] == 1)
-        return RIGHT; // Left border -> Right
-    if (exitGateX == WIDTH - 1 && map[exitGateY][exitGateX] == 1)
-        return LEFT; // Right border -> Left
-
-    // Rule 2: Gate in the middle of the map (not edge)
-    int clockwise[4]        = {3, 2, 0, 1}; // UP->RIGHT, DOWN->LEFT, LEFT->UP, RIGHT->DOWN
-    int counterClockwise[4] = {2, 3, 1, 0}; // UP->LEFT, DOWN->RIGHT, LEFT->DOWN, RIGHT->UP
-    int opposite[4]         = {1, 0, 3, 2}; // UP->DOWN, DOWN->UP, LEFT->RIGHT, RIGHT->LEFT
-
-    std::vector<int> possibleDirections;
-    // Priority 1: Same as entry direction
-    possibleDirections.push_back(entryDirection);
-    // Priority 2: Clockwise rotation
-    possibleDirections.push_back(clockwise[entryDirection]);
-    // Priority 3: Counter-clockwise rotation
-    possibleDirections.push_back(counterClockwise[entryDirection]);
-    // Priority 4: Opposite direction
-    possibleDirections.push_back(opposite[entryDirection]);
-
-    for (int d : possibleDirections) {
-        int nextY = exitGateY + dy[d];
-        int nextX = exitGateX + dx[d];
-
-        if (nextY >= 0 && nextY < HEIGHT && nextX >= 0 && nextX < WIDTH &&
-            (map[nextY][nextX] == 0 || map[nextY][nextX] == 4 || map[nextY][nextX] == 2)) {
-            return d;
-        }
-    }
-    // Fallback (should be rare if map gen is good)
-    for (int d = 0; d < 4; ++d) { // Check all four directions as a last resort
-        int nextY = exitGateY + dy[d];
-        int nextX = exitGateX + dx[d];
-        if (nextY >= 0 && nextY < HEIGHT && nextX >= 0 && nextX < WIDTH &&
-            (map[nextY][nextX] == 0 || map[nextY][nextX] == 4 || map[nextY][nextX] == 2)) {
-            return d;
-        }
+    if (y >= 0 && y < HUD_ROWS) {
+        if (hudCache[y] == line)
+            return;
+        hudCache[y] = line;
     }
-    return entryDirection; // Last resort: stick to entry if all else fails
-}
-
-void teleportThroughGate(int &y, int &x, int entryDirection) {
-    int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
-    int dx[4] = {0, 0, -1, 1};
-
-    std::pair<int, int> otherGate;
-    int                 exitGateY, exitGateX;
-
-    if (y == gateA.first && x == gateA.second) {
-        otherGate = gateB;
+    if (ansiBackend) {
+        ansiScreen.line(y, x, "%s", line);
     } else {
-        otherGate = gateA;
+        mvaddstr(y, x, line);
+        clrtoeol();
     }
-
-    exitGateY = otherGate.first;
-    exitGateX = otherGate.second;
-
-    int newExitDirection = calculateExitDirection(exitGateY, exitGateX, entryDirection);
-
-    // Place the snake head *outside* the exit gate, in the new direction of travel
-    y = exitGateY + dy[newExitDirection];
-    x = exitGateX + dx[newExitDirection];
-
-    dirIndex = newExitDirection; // Update snake's global direction
 }
 
-
-void moveSnake() {
-    static int gateCooldown = 0;
-    int        dy[4]        = {-1, 1, 0, 0};
-    int        dx[4]        = {0, 0, -1, 1};
-
-    int ny = headY + dy[dirIndex];
-    int nx = headX + dx[dirIndex];
-
-    // Item expiration
-    if (itemFrame > 0) {
-        if (--itemFrame == 0) {
-            for (int y = 0; y < HEIGHT; ++y)
-                for (int x = 0; x < WIDTH; ++x)
-                    if (map[y][x] == 4 || map[y][x] == 2)
-                        map[y][x] = 0;
-        }
-    }
-
-    // Boundary collision
-    if (ny < 0 || ny >= HEIGHT || nx < 0 || nx >= WIDTH) {
-        gameOverReason = 2;
-        return;
-    }
-
-    int tgt = map[ny][nx];
-    // Wall or self collision
-    if (tgt != 5 && (tgt == 1 || tgt == IMMUNE_WALL || tgt == 3)) {
-        gameOverReason = (tgt == 3 ? 3 : 2);
-        return;
-    }
-
-    bool grew = false;
-
-    if (tgt == 4) { // Growth
-        collected_growth_items++;
-        total_score_growth += 10;
-        grew        = true; // skip tail removal
-        map[ny][nx] = 0;
-        spawnGrowthItem();
-    } else if (tgt == 2) { // Poison
-        collected_poison_items++;
-        total_score_poison -= 5;
-        if (!snake.empty()) {
-            auto tail                    = snake.back();
-            map[tail.first][tail.second] = 0;
-            snake.pop_back(); // remove exactly 1 segment
-            if (snake.size() < 3) {
-                gameOverReason = 5;
-                return;
-            }
-        }
-        // grew remains false after eating poison (do not set grew = true here)
-        map[ny][nx] = 0;
-        spawnPoisonItem();
-    } else if (tgt == 5) { // Gate
-        if (gateCooldown > 0) {
-            gameOverReason = 6;
-            return;
-        }
-        gates_used_count++;
-        total_score_gate += 20;
-        int entry = dirIndex;
-        teleportThroughGate(ny, nx, entry);
-        if (ny < 0 || ny >= HEIGHT || nx < 0 || nx >= WIDTH || map[ny][nx] == 1 ||
-            map[ny][nx] == IMMUNE_WALL || map[ny][nx] == 3) {
-            gameOverReason = (map[ny][nx] == 3 ? 3 : 2);
-            return;
-        }
-        gateCooldown = GATE_COOLDOWN_TICKS;
-    }
-
-    // Normal move tail removal
-    if (!grew) {
-        if (!snake.empty()) {
-            auto tail                    = snake.back();
-            map[tail.first][tail.second] = 0;
-            snake.pop_back();
-        }
-    }
-
-    // Advance head
-    headY = ny;
-    headX = nx;
-    snake.push_front({headY, headX});
-    map[headY][headX] = 3;
-
-    // Turn counter & limits
-    if (++stageTurnCounter > stageTurnLimitPerStage[currentStage]) {
-        gameOverReason = 4;
+// Messages over the game screen (pause, quit, warnings), in red and bold when `alert`.
+void overlayText(int y, int x, const char *text, bool alert) {
+    if (ansiBackend) {
+        ansiScreen.moveTo(y, x);
+        ansiScreen.out += alert ? "\x1b[1;31m" : "";
+        ansiScreen.out += text;
+        ansiScreen.out += alert ? "\x1b[0m" : "";
         return;
     }
-
-    // Track max length
-    maxLengthAchieved = std::max(maxLengthAchieved, (int)snake.size());
-
-    // Gate cooldown tick
-    if (gateCooldown > 0)
-        --gateCooldown;
-
-    prevDirIndex = dirIndex;
+    if (alert)
+        attron(COLOR_PAIR(2) | A_BOLD);
+    mvaddstr(y, x, text);
+    if (alert)
+        attroff(COLOR_PAIR(2) | A_BOLD);
 }
 
-void spawnGrowthItem() {
-    int count = 0;
-    for (int i = 0; i < HEIGHT; ++i)
-        for (int j = 0; j < WIDTH; ++j)
-            if (map[i][j] == 4)
-                count++;
-    if (count >= maxGrowthItems)
+// Non-blocking stdout while an adaptive game runs, so a slow terminal shows up as pending
+// output instead of stalling the game loop. ncurses and getch() need it blocking again.
+void setOutputBlocking(bool blocking) {
+    if (!adaptiveOn)
         return;
-
-    int y, x;
-    do {
-        y = rand() % HEIGHT;
-        x = rand() % WIDTH;
-    } while (map[y][x] != 0); // Ensure empty spot
-    map[y][x] = 4;             // Growth item
-    itemFrame = ITEM_LIFESPAN; // Reset item lifespan
-}
-
-void spawnPoisonItem() {
-    int count = 0;
-    for (int i = 0; i < HEIGHT; ++i)
-        for (int j = 0; j < WIDTH; ++j)
-            if (map[i][j] == 2)
-                count++;
-    if (count >= maxPoisonItems)
+    int flags = fcntl(STDOUT_FILENO, F_GETFL);
+    if (flags < 0)
         return;
-
-    int y, x;
-    do {
-        y = rand() % HEIGHT;
-        x = rand() % WIDTH;
-    } while (map[y][x] != 0); // Ensure empty spot
-    map[y][x] = 2;             // Poison item
-    itemFrame = ITEM_LIFESPAN; // Reset item lifespan
+    fcntl(STDOUT_FILENO, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+    if (blocking)
+        ansiScreen.flushPending(STDOUT_FILENO);
 }
 
-void spawnGates() {
-    // Clear old gates first
-    if (gateA.first != -1)
-        map[gateA.first][gateA.second] = 1; // Revert to wall
-    if (gateB.first != -1)
-        map[gateB.first][gateB.second] = 1; // Revert to wall
-    gateA = {-1, -1};
-    gateB = {-1, -1};
-
-    std::vector<std::pair<int, int>> wallCandidates;
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            if (map[y][x] == 1) { // Only normal walls can become gates
-                // Check if there's an adjacent empty space for snake to exit *into*
-                bool hasValidExitSpace = false;
-                int  dy[]              = {-1, 1, 0, 0};
-                int  dx[]              = {0, 0, -1, 1};
-                for (int i = 0; i < 4; ++i) {
-                    int adjY = y + dy[i];
-                    int adjX = x + dx[i];
-                    if (adjY >= 0 && adjY < HEIGHT && adjX >= 0 && adjX < WIDTH &&
-                        map[adjY][adjX] == 0) {
-                        hasValidExitSpace = true;
-                        break;
-                    }
-                }
-                if (hasValidExitSpace) {
-                    wallCandidates.push_back({y, x});
-                }
-            }
-        }
+// Sends what was drawn of the game screen to the terminal.
+void presentFrame() {
+    if (!ansiBackend) {
+        refresh();
+        return;
     }
-
-    if (wallCandidates.size() < 2)
-        return; // Not enough walls to form a pair of gates
-
-    std::shuffle(wallCandidates.begin(), wallCandidates.end(), gen);
-
-    gateA = wallCandidates[0];
-    gateB = wallCandidates[1];
-
-    map[gateA.first][gateA.second] = 5; // Mark as gate
-    map[gateB.first][gateB.second] = 5; // Mark as gate
-    gateLifetimeCounter            = 0; // Reset gate lifespan timer
+    bool probe = adaptiveOn && pacer.probeDue();
+    if (probe)
+        ansiScreen.out += PACER_PROBE;
+    pacer.wrote(ansiScreen.out.size());
+    ansiScreen.writeFrame(STDOUT_FILENO);
+    if (probe)
+        pacer.probeSent(monotonicNs());
 }
 
-// void initStage(int stage) {
-//     // 1. Clear any old snake body
-//     snake.clear();
-
-//     // 2. Compute center
-//     headY = HEIGHT / 2;
-//     headX = WIDTH / 2;
-
-//     // 3. Place exactly 3 segments: head + 2 body
-//     // Place initial snake of length 3 at center (head + 2 body)
-//     snake.push_front({headY, headX});    // head
-//     snake.push_back({headY, headX - 1}); // body segment 1
-//     snake.push_back({headY, headX - 2}); // body segment 2
-
-//     // 4. (Optional) Reset your length variable if you use it
-//     length = 3;
-
-//     // 5. Mark them on the map
-//     for (auto &seg : snake) {
-//         map[seg.first][seg.second] = 3;
-//     }
-
-
-//     stageTurnCounter = 0;
-
-//     // Reset gate related variables for the new stage
-//     gateSpawned         = false;
-//     gateLifetimeCounter = 0;
-//     gateEntryY          = -1;
-//     gateEntryX          = -1;
-//     gateExitY           = -1;
-//     gateExitX           = -1;
-
-//     // Reset item frame for new stage
-//     itemFrame = ITEM_LIFESPAN;
-
-//     // Generate map with edge walls and inner walls based on stage
-//     for (int i = 0; i < HEIGHT; ++i) {
-//         for (int j = 0; j < WIDTH; ++j) {
-//             // Corners are immune walls
-//             if ((i == 0 || i == HEIGHT - 1) && (j == 0 || j == WIDTH - 1)) {
-//                 map[i][j] = IMMUNE_WALL;
-//             }
-//             // Edges (excluding corners) are normal walls
-//             else if (i == 0 || i == HEIGHT - 1 || j == 0 || j == WIDTH - 1) {
-//                 map[i][j] = 1;
-//             }
-//             // Interior: empty for now
-//             else {
-//                 map[i][j] = 0;
-//             }
-//         }
-//     }
-
-//     // Place inner walls at stage-specific probability
-//     double prob = innerWallProbability[stage]; // percentage chance for a wall
-//     for (int i = 1; i < HEIGHT - 1; ++i) {
-//         for (int j = 1; j < WIDTH - 1; ++j) {
-//             if (map[i][j] == 0) {
-//                 if ((rand() / (double)RAND_MAX) * 100.0 < prob) {
-//                     map[i][j] = 1;
-//                 }
-//             }
-//         }
-//     }
-
-//     // Ensure center area is clear for snake placement
-//     headY                 = HEIGHT / 2;
-//     headX                 = WIDTH / 2;
-//     map[headY][headX]     = 0;
-//     map[headY][headX - 1] = 0;
-//     map[headY][headX - 2] = 0;
-
-//     // Place initial snake of length 3 at center
-//     snake.push_front({headY, headX});
-//     snake.push_front({headY, headX - 1});
-//     snake.push_front({headY, headX - 2});
-//     length = 3; // Initial snake length fixed to 3 (head + 2 body segments)
-//     for (const auto &segment : snake) {
-//         map[segment.first][segment.second] = 3;
-//     }
-//     // Clear the cell immediately to the right of the head
-//     map[headY][headX + 1] = 0;
-
-//     dirIndex     = RIGHT;
-//     prevDirIndex = RIGHT;
-
-//     // Spawn initial items and gates for the new stage
-//     spawnGrowthItem();
-//     spawnPoisonItem();
-//     spawnGates();
-// }
-
-void initStage(int stage) {
-    // Clear any existing snake segments
-    snake.clear();
-    // Reset turn counter
-    stageTurnCounter = 0;
-    // Reset gates
-    gateSpawned         = false;
-    gateLifetimeCounter = 0;
-    gateEntryY = gateEntryX = gateExitY = gateExitX = -1;
-    // Reset items
-    itemFrame = ITEM_LIFESPAN;
-
-    // Build walls
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            if ((y == 0 || y == HEIGHT - 1) && (x == 0 || x == WIDTH - 1))
-                map[y][x] = IMMUNE_WALL;
-            else if (y == 0 || y == HEIGHT - 1 || x == 0 || x == WIDTH - 1)
-                map[y][x] = 1;
-            else
-                map[y][x] = 0;
-        }
-    }
-    // Place inner walls
-    double prob = innerWallProbability[stage];
-    for (int y = 1; y < HEIGHT - 1; ++y) {
-        for (int x = 1; x < WIDTH - 1; ++x) {
-            if (map[y][x] == 0 && (rand() / (double)RAND_MAX) * 100.0 < prob) {
-                map[y][x] = 1;
-            }
-        }
-    }
-
-    // Center start
-    headY = HEIGHT / 2;
-    headX = WIDTH / 2;
-    // Clear center cells
-    map[headY][headX]     = 0;
-    map[headY][headX - 1] = 0;
-    map[headY][headX - 2] = 0;
-
-    // Place snake: head + 2 body segments
-    snake.push_front({headY, headX});     // head
-    snake.push_front({headY, headX - 1}); // body 1
-    snake.push_front({headY, headX - 2}); // body 2
-    length = 3;                           // enforce length = 3
-    for (auto &seg : snake) {
-        map[seg.first][seg.second] = 3;
+// Waits a while for the answer to an outstanding probe, so it doesn't reach getch() as
+// keys once the input thread is gone; a terminal that never answered isn't waited for.
+// Keys typed meanwhile are handed on to getch() if `keepKeys`. Output must be blocking
+// again by then.
+void settleProbe(InputThread &input, bool keepKeys) {
+    long long deadline = monotonicNs() + PACER_SETTLE_NS;
+    KeyEvent  event;
+    while (pacer.answering && pacer.probePending() && monotonicNs() < deadline) {
+        if (!input.poll(event))
+            usleep(1000);
+        else if (event.key == KEY_CURSOR_REPORT)
+            pacer.probeAnswered(event.timeNs);
+        else if (keepKeys)
+            ungetch(event.key);
     }
-
-    // Initialize direction
-    dirIndex     = RIGHT;
-    prevDirIndex = RIGHT;
-
-    // Spawn first items/gates
-    spawnGrowthItem();
-    spawnPoisonItem();
-    spawnGates();
-}
-
-void initColors() {
-    start_color();
-    // Pair 1: Snake Body (Green on Black)
-    init_pair(1, COLOR_GREEN, COLOR_BLACK);
-    // Pair 2: Poison Item / Game Over Message (Red on Black)
-    init_pair(2, COLOR_RED, COLOR_BLACK);
-    // Pair 3: Snake Head / Growth Item (Yellow on Black)
-    init_pair(3, COLOR_YELLOW, COLOR_BLACK);
-    // Pair 4: Gate (Blue on Black)
-    init_pair(4, COLOR_BLUE, COLOR_BLACK);
-    // Pair 5: Wall (White on Black)
-    init_pair(5, COLOR_WHITE, COLOR_BLACK);
-    // Pair 6: Immune Wall (Cyan on Black)
-    init_pair(6, COLOR_CYAN, COLOR_BLACK);
-    // Pair 7: Highlight / Selected Menu Item (Black on White or other contrast)
-    init_pair(7, COLOR_BLACK, COLOR_WHITE); // Example for selected menu
-    // Pair 8: General Text (White on Black - default, but can be explicit)
-    init_pair(8, COLOR_WHITE, COLOR_BLACK);
 }
 
 void inputPlayerName() {
@@ -693,6 +246,10 @@ void inputPlayerName() {
 }
 
 void loadHighScore() {
+    if (sharedBoardReady) {
+        highScore = sharedBoard.highScore();
+        return;
+    }
     std::ifstream file("highscore.txt");
     if (file.is_open()) {
         file >> highScore;
@@ -703,6 +260,12 @@ void loadHighScore() {
 }
 
 void saveHighScore(int current_game_score) {
+    // highscore.txt is then written by whichever process persists the shared board
+    if (sharedBoardReady) {
+        sharedBoard.offerHighScore(current_game_score);
+        highScore = sharedBoard.highScore();
+        return;
+    }
     int           currentHigh = 0;
     std::ifstream infile("highscore.txt");
     if (infile.is_open()) {
@@ -725,75 +288,104 @@ std::string wstring_to_string(const std::wstring &ws) {
     return s;
 }
 
+// Records the game in the leaderboard and remembers its rank for the game over screen.
+// With the shared board the game shows up everywhere at once and is written to disk in
+// the background; the game over screen picks up its rank when that's done.
 void saveRanking(const std::wstring &name, int score) {
-    // 1) Append the new entry
-    {
-        std::ofstream file("ranking.txt", std::ios::app);
-        if (file.is_open()) {
-            file << wstring_to_string(name) << " " << score << "\n";
-        }
+    if (sharedBoardReady) {
+        lastSequence = sharedBoard.insert(wstring_to_string(name), score);
+        sharedBoard.persistAsync();
+        return;
     }
+    Leaderboard board;
+    lastRank        = board.open() ? board.insert(wstring_to_string(name), score) : -1;
+    rankedGameCount = board.size();
+}
 
-    // 2) Load all entries into memory
-    std::vector<PlayerInfo> entries;
-    {
-        std::ifstream infile("ranking.txt");
-        std::string   line;
-        while (std::getline(infile, line)) {
-            if (line.empty())
-                continue;
-            size_t pos = line.find_last_of(' ');
-            if (pos == std::string::npos)
-                continue;
-            std::string n = line.substr(0, pos);
-            int         s = std::stoi(line.substr(pos + 1));
-            entries.push_back({n, s});
-        }
+// Draws one page of the ranking. `highlight` is the 0-based position to mark, if any.
+void drawRankingPage(const std::vector<LeaderboardRow> &rows, long long total, long long highlight,
+                     const std::string &status, int pageSize) {
+    int max_y, max_x;
+    getmaxyx(stdscr, max_y, max_x); // Get screen dimensions
+    clear();
+
+    const char *title = "👑 TOP RANKING 👑";
+    mvprintw(8, (max_x - (int)strlen(title)) / 2, "%s", title);
+
+    int start_y = 10; // Starting Y position for the ranks
+
+    // Compute max entry length among the entries shown
+    int maxEntryLen = 0;
+    for (const LeaderboardRow &row : rows) {
+        int entryLen = (int)(std::to_string(row.rank).size() + 2 + row.name.size() + 2 +
+                             std::to_string(row.score).size());
+        maxEntryLen  = std::max(maxEntryLen, entryLen);
     }
+    int start_x = (max_x - maxEntryLen) / 2;
 
-    // 3) Sort descending by score
-    std::sort(entries.begin(), entries.end(), std::greater<PlayerInfo>());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        bool marked = rows[i].rank - 1 == highlight;
+        if (marked)
+            attron(COLOR_PAIR(7));
+        mvprintw(start_y + (int)i, start_x, "%lld. %.*s: %d", rows[i].rank,
+                 (int)rows[i].name.size(), rows[i].name.data(), rows[i].score);
+        if (marked)
+            attroff(COLOR_PAIR(7));
+    }
 
-    // 4) Trim to top 100
-    if (entries.size() > 100) {
-        entries.resize(100);
+    if (rows.empty()) {
+        const char *no_ranks_msg = "No ranking yet.";
+        int         noRanksLen   = strlen("No ranking yet.");
+        int         noRanksX     = (max_x - noRanksLen) / 2;
+        mvprintw(start_y, noRanksX, "%s", no_ranks_msg);
     }
 
-    // 5) Rewrite file with only top 100
-    {
-        std::ofstream outfile("ranking.txt", std::ios::trunc);
-        for (const auto &p : entries) {
-            outfile << p.name << " " << p.score << "\n";
-        }
+    int footer_y = start_y + pageSize + 1;
+    if (!rows.empty()) {
+        std::string range = "Ranks " + std::to_string(rows.front().rank) + "-" +
+                            std::to_string(rows.back().rank) + " of " + std::to_string(total);
+        mvprintw(footer_y, (max_x - (int)range.size()) / 2, "%s", range.c_str());
     }
+    const char *help = "PgUp/PgDn: page  Home/End: first/last  m: my rank  /: search  n: next";
+    mvprintw(footer_y + 1, (max_x - (int)strlen(help)) / 2, "%s", help);
+    if (!status.empty())
+        mvprintw(footer_y + 2, (max_x - (int)status.size()) / 2, "%s", status.c_str());
+
+    const char *return_prompt = "Press [spacebar] to return to the menu.";
+    mvprintw(std::min(footer_y + 4, max_y - 1), (max_x - (int)strlen(return_prompt)) / 2, "%s",
+             return_prompt);
+    refresh();
 }
 
-void showRankingScreen() {
-    clear();
-    int max_y, max_x;
-    getmaxyx(stdscr, max_y, max_x); // Get screen dimensions
+// Reads a name to search for on the line below the ranking.
+std::string promptSearchName(int y) {
+    const char *prompt = "Search name: ";
+    move(y, 0);
+    clrtoeol();
+    mvprintw(y, (COLS - 40) / 2, "%s", prompt);
+    echo();
+    curs_set(1);
+    timeout(-1); // Wait for input
 
-    const char *title = "👑 TOP RANKING 👑";
-    mvprintw(8, (max_x - (int)strlen(title)) / 2, "%s", title);
+    char name_buffer[31];
+    if (getnstr(name_buffer, 30) != OK)
+        name_buffer[0] = '\0';
 
-    std::vector<PlayerInfo> ranking;
-    std::ifstream           rankFile("ranking.txt");
+    noecho();
+    curs_set(0);
+    timeout(RANKING_REFRESH_MS);
+    return name_buffer;
+}
 
-    if (rankFile.is_open()) {
-        std::string line;
-        while (std::getline(rankFile, line)) {
-            if (line.empty())
-                continue;
-            // Find last space to separate name and score
-            size_t pos = line.find_last_of(' ');
-            if (pos == std::string::npos)
-                continue;
-            std::string name_str = line.substr(0, pos);
-            int         score    = std::stoi(line.substr(pos + 1));
-            ranking.push_back({name_str, score});
-        }
-        rankFile.close();
-    } else {
+// Pages through the whole store without loading it: each page is read straight out of the
+// mapped ranking file. The first page follows the shared top list live.
+void showRankingScreen() {
+    Leaderboard board;
+    bool        storeReady = board.open();
+    if (!storeReady && !sharedBoardReady) {
+        int max_y, max_x;
+        getmaxyx(stdscr, max_y, max_x); // Get screen dimensions
+        clear();
         const char *error_msg = "Unable to read the ranking file.";
         mvprintw(max_y / 2, (max_x - (int)strlen(error_msg)) / 2, "%s", error_msg);
         const char *return_msg = "(Press Space to return)";
@@ -804,42 +396,95 @@ void showRankingScreen() {
         return;
     }
 
-    // Sort ranking by score in descending order
-    std::sort(ranking.begin(), ranking.end(), std::greater<PlayerInfo>());
-
-    int start_y = 10; // Starting Y position for the ranks
-
-    // Compute max entry length among entries to be shown (up to 20)
-    int maxEntryLen  = 0;
-    int displayCount = std::min((int)ranking.size(), 20);
-    for (int i = 0; i < displayCount; ++i) {
-        std::string rank_entry_str = std::to_string(i + 1) + ". " + ranking[i].name + ": " +
-                                     std::to_string(ranking[i].score);
-        if ((int)rank_entry_str.length() > maxEntryLen) {
-            maxEntryLen = rank_entry_str.length();
+    std::vector<LeaderboardRow>   rows;
+    std::vector<LeaderboardEntry> liveTop;        // Backs the first page's names
+    long long                     first     = 0;  // Position of the first row shown
+    long long                     highlight = -1; // Position of the marked row, if any
+    std::string                   status, lastSearch;
+    std::uint32_t                 shownVersion = 0;
+    long long                     shownStored  = -1;
+    bool                          dirty        = true;
+
+    timeout(RANKING_REFRESH_MS);
+    for (;;) {
+        int max_y, max_x;
+        getmaxyx(stdscr, max_y, max_x);
+        int pageSize = std::max(1, std::min(20, max_y - 16));
+
+        // Another game finished: pick up what it added to the store
+        if (sharedBoardReady && (sharedBoard.topVersion() != shownVersion ||
+                                 sharedBoard.storedEntries() != shownStored)) {
+            shownVersion = sharedBoard.topVersion();
+            shownStored  = sharedBoard.storedEntries();
+            storeReady   = board.open();
+            dirty        = true;
+        }
+        long long total = storeReady ? board.size() : 0;
+
+        if (dirty) {
+            if (sharedBoardReady && first == 0) {
+                liveTop = sharedBoard.top(pageSize);
+                rows.clear();
+                for (size_t i = 0; i < liveTop.size(); ++i)
+                    rows.push_back({(long long)i + 1, liveTop[i].name, liveTop[i].score});
+                total = std::max(total, (long long)liveTop.size());
+            } else {
+                board.page(first, pageSize, rows);
+            }
+            drawRankingPage(rows, total, highlight, status, pageSize);
+            dirty = false;
         }
-    }
-    int start_x = (max_x - maxEntryLen) / 2;
 
-    for (int i = 0; i < displayCount; ++i) {
-        std::string rank_entry_str = std::to_string(i + 1) + ". " + ranking[i].name + ": " +
-                                     std::to_string(ranking[i].score);
-        mvprintw(start_y + i, start_x, "%s", rank_entry_str.c_str());
-    }
+        int ch = getch();
+        if (ch == ERR)
+            continue;
+        if (ch == ' ')
+            break;
 
-    if (ranking.empty()) {
-        const char *no_ranks_msg = "No ranking yet.";
-        int         noRanksLen   = strlen("No ranking yet.");
-        int         noRanksX     = (max_x - noRanksLen) / 2;
-        mvprintw(start_y, noRanksX, "%s", no_ranks_msg);
+        long long lastPage = total > 0 ? (total - 1) / pageSize * pageSize : 0;
+        status.clear();
+        switch (ch) {
+        case KEY_NPAGE:
+        case KEY_DOWN:
+            first = std::min(first + pageSize, lastPage);
+            break;
+        case KEY_PPAGE:
+        case KEY_UP:
+            first = std::max(first - pageSize, 0LL);
+            break;
+        case KEY_HOME:
+            first = 0;
+            break;
+        case KEY_END:
+            first = lastPage;
+            break;
+        case 'm':
+            if (lastRank > 0 && lastRank <= total) {
+                highlight = lastRank - 1;
+                first     = highlight - highlight % pageSize;
+            } else {
+                status = "No ranked game yet in this session.";
+            }
+            break;
+        case '/':
+        case 'n': {
+            if (ch == '/')
+                lastSearch = promptSearchName(10 + pageSize + 3);
+            if (lastSearch.empty())
+                break;
+            long long found = storeReady ? board.find(lastSearch, highlight + 1) : -1;
+            if (found >= 0) {
+                highlight = found;
+                first     = found - found % pageSize;
+            } else {
+                status = "No player named \"" + lastSearch + "\".";
+            }
+            break;
+        }
+        }
+        dirty = true;
     }
-
-    const char *return_prompt = "Press [spacebar] to return to the menu.";
-    mvprintw(max_y - 16, (max_x - (int)strlen(return_prompt)) / 2, "%s", return_prompt);
-    refresh();
-
-    while (getch() != ' ') {
-    } // Wait for spacebar press
+    timeout(100);
 }
 
 int showRulesScreen() {
@@ -870,6 +515,10 @@ int showRulesScreen() {
                  "-> Press 'P' during gameplay to pause; press again to resume.");
         mvprintw(current_y++, sub_indent,
                  "-> Press 'Q' anytime during gameplay to quit immediately.");
+        mvprintw(current_y++, sub_indent,
+                 "-> Press 'A' to let the autopilot steer (the game isn't ranked).");
+        mvprintw(current_y++, sub_indent,
+                 "-> Press 'T' to show how long each part of a tick takes.");
 
         current_y++; // Space
 
@@ -879,8 +528,9 @@ int showRulesScreen() {
         mvprintw(current_y++, sub_indent, "-> ☠️  Poison Item: -1 Length.");
         mvprintw(current_y++, sub_indent, "   Length below 3 = Game Over.");
         mvprintw(current_y++, sub_indent,
-                 "   Items vanish after %d ticks; max %d Growth, %d Poison.", ITEM_LIFESPAN,
-                 maxGrowthItems, maxPoisonItems);
+                 "   Items move after %d ticks; max %d Growth, %d Poison.",
+                 defaultRules.itemLifespan, defaultRules.maxGrowthItems,
+                 defaultRules.maxPoisonItems);
 
         current_y++; // Space
 
@@ -888,8 +538,9 @@ int showRulesScreen() {
         mvprintw(current_y++, main_indent, "🚪 Gates:");
         mvprintw(current_y++, sub_indent, "-> Pairs appear on walls (not corners).");
         mvprintw(current_y++, sub_indent, "   Enter one to teleport to the other.");
-        mvprintw(current_y++, sub_indent, "   Gates regenerate after %d ticks.",
-                 GATE_LIFESPAN_TICKS);
+        mvprintw(current_y++, sub_indent, "   Gates regenerate every %d-%d ticks (by stage).",
+                 defaultRules.gateRespawnIntervalPerStage[STAGES - 1],
+                 defaultRules.gateRespawnIntervalPerStage[0]);
         mvprintw(current_y++, sub_indent,
                  "   Cooldown: %d ticks. Using gate during cooldown = Game Over.",
                  GATE_COOLDOWN_TICKS);
@@ -975,10 +626,10 @@ int showMenuScreen() {
         getmaxyx(stdscr, current_height, current_width); // Use getmaxyx
 
         // Adjusted minimum size requirements (example)
-        // The game board itself is WIDTH*3 wide, plus scoreboard/mission board.
+        // The game board itself is boardWidth*3 wide, plus scoreboard/mission board.
         // Let's say scoreboard needs 30 chars.
-        int required_width  = WIDTH * 3 + 40; // Game map (21*3=63) + buffer for scoreboard/mission
-        int required_height = HEIGHT + 5;     // Game map (21) + buffer for messages/scoreboard
+        int required_width  = boardWidth * 3 + 40; // Game map (21*3=63) + scoreboard/mission
+        int required_height = boardHeight + 5;     // Game map (21) + messages/scoreboard
 
         if (current_height >= required_height && current_width >= required_width) {
             break; // Size is adequate
@@ -1062,109 +713,128 @@ int showMenuScreen() {
 }
 
 void drawScoreboard() {
-    int board_x_start = WIDTH * 3 + 5;
+    int board_x_start = game.width * 3 + 5;
     int current_y     = 1;
 
-    mvprintw(current_y++, board_x_start, "----- SCOREBOARD -----");
-    mvprintw(current_y++, board_x_start, "🍎 Growth Items: %d pts", total_score_growth);
-    mvprintw(current_y++, board_x_start, "☠️  Poison Items: %d pts", total_score_poison);
-    mvprintw(current_y++, board_x_start, "🚪 Gates Used  : %d pts", total_score_gate);
-
-    int currentTotalScore = total_score_growth + total_score_poison + total_score_gate;
-    mvprintw(current_y++, board_x_start, "----------------------");
-    mvprintw(current_y++, board_x_start, "🏆 Current Score: %d", currentTotalScore);
-    mvprintw(current_y++, board_x_start, "⭐ High Score   : %d", highScore);
-    mvprintw(current_y++, board_x_start, "----------------------");
-
-    if (itemFrame > 0) {
-        mvprintw(current_y++, board_x_start, "⏳ Items Despawn: %d ticks", itemFrame);
+    hudPrintw(current_y++, board_x_start, "----- SCOREBOARD -----");
+    hudPrintw(current_y++, board_x_start, "🍎 Growth Items: %d pts", game.total_score_growth);
+    hudPrintw(current_y++, board_x_start, "☠️  Poison Items: %d pts", game.total_score_poison);
+    hudPrintw(current_y++, board_x_start, "🚪 Gates Used  : %d pts", game.total_score_gate);
+
+    hudPrintw(current_y++, board_x_start, "----------------------");
+    hudPrintw(current_y++, board_x_start, "🏆 Current Score: %d", currentScore(game));
+    if (sharedBoardReady) // Other games may have beaten it since we started
+        highScore = std::max(highScore, sharedBoard.highScore());
+    hudPrintw(current_y++, board_x_start, "⭐ High Score   : %d", highScore);
+    hudPrintw(current_y++, board_x_start, "----------------------");
+
+    int itemTicks = itemTicksLeft(game);
+    int gateTicks = gateTicksLeft(game);
+    if (itemTicks > 0) {
+        hudPrintw(current_y++, board_x_start, "⏳ Items Despawn: %d ticks", itemTicks);
     } else {
-        mvprintw(current_y++, board_x_start, "⏳ Items Despawn: N/A");
+        hudPrintw(current_y++, board_x_start, "⏳ Items Despawn: N/A");
     }
-    if (gateA.first != -1) {
-        mvprintw(current_y++, board_x_start, "⏳ Gates Despawn: %d ticks",
-                 gateLifespan - gateLifetimeCounter);
+    if (gateTicks > 0) {
+        hudPrintw(current_y++, board_x_start, "⏳ Gates Despawn: %d ticks", gateTicks);
     } else {
-        mvprintw(current_y++, board_x_start, "⏳ Gates Despawn: N/A");
+        hudPrintw(current_y++, board_x_start, "⏳ Gates Despawn: N/A");
     }
+    hudPrintw(current_y++, board_x_start, "%s",
+              autopilotOn ? "🤖 Autopilot ON ('a' to stop)" : "");
 }
 
 void drawMissionBoard() {
-    int board_x_start = WIDTH * 3 + 5;
+    int board_x_start = game.width * 3 + 5;
     int current_y     = 1; // Start Y position
     // Calculate current_y based on drawScoreboard's height more accurately
     // Title + 3 scores + separator + 2 totals + separator + 2 lifespans + spacing
     current_y = 1 + 3 + 1 + 2 + 1 + 2 + 2;
 
-    mvprintw(current_y++, board_x_start, "-------- MISSION (Stage %d) --------", currentStage + 1);
+    hudPrintw(current_y++, board_x_start, "-------- MISSION (Stage %d) --------",
+             game.currentStage + 1);
     std::string mission_status_char_str; // Use string for status
 
     // Length Mission
-    int req_len = mission_length_per_stage[currentStage];
+    int req_len = game.rules->mission_length_per_stage[game.currentStage];
     mission_status_char_str =
-        (snake.size() >= req_len) ? "✅" : "  "; // Use string with spaces for alignment
-    mvprintw(current_y++, board_x_start, "🐍 Length: %ld/%d (%s) (Max: %d)", snake.size(), req_len,
-             mission_status_char_str.c_str(), maxLengthAchieved);
+        (game.snake.size() >= req_len) ? "✅" : "  "; // Use string with spaces for alignment
+    hudPrintw(current_y++, board_x_start, "🐍 Length: %d/%d (%s) (Max: %d)",
+             game.snake.size(), req_len, mission_status_char_str.c_str(),
+             game.maxLengthAchieved);
 
     // Growth Item Mission
-    int req_growth          = mission_growth_per_stage[currentStage];
-    mission_status_char_str = (collected_growth_items >= req_growth) ? "✅" : "  ";
-    mvprintw(current_y++, board_x_start, "🍎 Growth: %d/%d (%s)", collected_growth_items,
+    int req_growth          = game.rules->mission_growth_per_stage[game.currentStage];
+    mission_status_char_str = (game.collected_growth_items >= req_growth) ? "✅" : "  ";
+    hudPrintw(current_y++, board_x_start, "🍎 Growth: %d/%d (%s)", game.collected_growth_items,
              req_growth, mission_status_char_str.c_str());
 
     // Poison Item Mission
-    int req_poison          = mission_poison_per_stage[currentStage];
-    mission_status_char_str = (collected_poison_items >= req_poison) ? "✅" : "  ";
-    mvprintw(current_y++, board_x_start, "☠️  Poison: %d/%d (%s)", collected_poison_items,
+    int req_poison          = game.rules->mission_poison_per_stage[game.currentStage];
+    mission_status_char_str = (game.collected_poison_items >= req_poison) ? "✅" : "  ";
+    hudPrintw(current_y++, board_x_start, "☠️  Poison: %d/%d (%s)", game.collected_poison_items,
              req_poison, mission_status_char_str.c_str());
 
     // Gate Usage Mission
-    int req_gate            = mission_gate_per_stage[currentStage];
-    mission_status_char_str = (gates_used_count >= req_gate) ? "✅" : "  ";
-    mvprintw(current_y++, board_x_start, "🚪 Gates : %d/%d (%s)", gates_used_count, req_gate,
+    int req_gate            = game.rules->mission_gate_per_stage[game.currentStage];
+    mission_status_char_str = (game.gates_used_count >= req_gate) ? "✅" : "  ";
+    hudPrintw(current_y++, board_x_start, "🚪 Gates : %d/%d (%s)", game.gates_used_count, req_gate,
              mission_status_char_str.c_str());
-    mvprintw(current_y++, board_x_start, "----------------------------------");
+    hudPrintw(current_y++, board_x_start, "----------------------------------");
 
-    int turns_remaining = stageTurnLimitPerStage[currentStage % STAGES] - stageTurnCounter;
-    mvprintw(current_y++, board_x_start, "⏱️  Turns Left: %d", turns_remaining);
+    int turns_remaining =
+        game.rules->stageTurnLimitPerStage[game.currentStage % STAGES] - game.stageTurnCounter;
+    hudPrintw(current_y++, board_x_start, "⏱️  Turns Left: %d", turns_remaining);
 
-    if (checkMissionClear()) {
+    if (checkMissionClear(game) && ansiBackend) {
+        hudPrintw(current_y++, board_x_start, "\x1b[1;32m🎉 MISSION COMPLETE! 🎉\x1b[0m");
+    } else if (checkMissionClear(game)) {
         attron(COLOR_PAIR(1) | A_BOLD);
-        mvprintw(current_y++, board_x_start, "🎉 MISSION COMPLETE! 🎉");
+        hudPrintw(current_y++, board_x_start, "🎉 MISSION COMPLETE! 🎉");
         attroff(COLOR_PAIR(1) | A_BOLD);
     } else {
-        mvprintw(current_y++, board_x_start, "   (Keep Going!)");
+        hudPrintw(current_y++, board_x_start, "   (Keep Going!)");
     }
-    mvprintw(current_y++, board_x_start, "----------------------------------");
+    hudPrintw(current_y++, board_x_start, "----------------------------------");
 }
 
-// This function checks if all mission objectives for the current stage are met.
-bool checkMissionClear() {
-    int  stageIdx    = currentStage;
-    bool lengthClear = ((int)snake.size() >= mission_length_per_stage[stageIdx]);
-    bool growthClear = (collected_growth_items >= mission_growth_per_stage[stageIdx]);
-    bool poisonClear = (collected_poison_items >= mission_poison_per_stage[stageIdx]);
-    bool gateClear   = (gates_used_count >= mission_gate_per_stage[stageIdx]);
-
-    missionStatusLength[stageIdx] = lengthClear;
-    missionStatusGrowth[stageIdx] = growthClear;
-    missionStatusPoison[stageIdx] = poisonClear;
-    missionStatusGate[stageIdx]   = gateClear;
-
-    return lengthClear && growthClear && poisonClear && gateClear;
+// Below the mission board: p50/p99/max of each tick phase so far, in microseconds.
+void drawProfileOverlay() {
+    int board_x_start = game.width * 3 + 5;
+    int current_y     = 1 + 3 + 1 + 2 + 1 + 2 + 2 + 10; // Below drawMissionBoard()'s rows
+
+    hudPrintw(current_y++, board_x_start, "--- TICK PROFILE (us, budget %d ms) ---",
+              delay_per_stage[game.currentStage] / 1000);
+    hudPrintw(current_y++, board_x_start, "%-8s %8s %8s %8s", "phase", "p50", "p99", "max");
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        const LatencyHistogram &h = tickProfile.phases[i];
+        hudPrintw(current_y++, board_x_start, "%-8s %8.1f %8.1f %8.1f", tickPhaseNames[i],
+                  h.percentileNs(0.50) / 1000.0, h.percentileNs(0.99) / 1000.0,
+                  h.maxNs / 1000.0);
+    }
+    hudPrintw(current_y++, board_x_start, "over budget: %lld of %lld ticks",
+              tickProfile.overBudget, tickProfile.phases[PHASE_TICK].total);
+    if (ansiBackend)
+        hudPrintw(current_y++, board_x_start, "frame: %.0f bytes, %.2f write() (max %lld)",
+                  ansiScreen.stats.bytesPerFrame(), ansiScreen.stats.writesPerFrame(),
+                  ansiScreen.stats.maxBytes);
+    if (adaptiveOn)
+        hudPrintw(current_y++, board_x_start, "link: %.1f KB/s, rtt %.0f ms, %lld B behind%s",
+                  pacer.rate / 1000, pacer.baseRttNs / 1e6, pacer.backlog,
+                  pacer.compact ? ", ascii" : "");
 }
 
 void showGameOverScreen(int finalScore) {
     clear();
     std::string title =
-        gameWon ? "🎉 CONGRATULATIONS! ALL STAGES CLEARED! 🎉" : " G A M E   O V E R ";
+        game.gameWon ? "🎉 CONGRATULATIONS! ALL STAGES CLEARED! 🎉" : " G A M E   O V E R ";
     attron(COLOR_PAIR(2) | A_BOLD);
     mvprintw(LINES / 2 - 5, (COLS - title.length()) / 2, "%s", title.c_str());
     attroff(COLOR_PAIR(2) | A_BOLD);
 
     std::string reasonMessage = "";
-    if (!gameWon) {
-        switch (gameOverReason) {
+    if (!game.gameWon) {
+        switch (game.gameOverReason) {
         case 1:
             reasonMessage = "Reason: U-turn attempted (꼬리 방향 이동).";
             break;
@@ -1187,7 +857,7 @@ void showGameOverScreen(int finalScore) {
             reasonMessage = "Reason: Pressed 'Q' to quit ('Q'를 눌러 종료).";
             break;
         default:
-            reasonMessage = "Reason: Unknown mishap on the snake trail!";
+            reasonMessage = "Reason: Unknown mishap on the game.snake trail!";
             break;
         }
         mvprintw(LINES / 2 - 3, (COLS - (int)reasonMessage.length()) / 2, "%s",
@@ -1201,46 +871,29 @@ void showGameOverScreen(int finalScore) {
     std::string stats_title = "------ Final Stats ------";
     mvprintw(LINES / 2 + 1, (COLS - (int)stats_title.length()) / 2, "%s", stats_title.c_str());
 
-    std::string length_stat = "Max Length Achieved: " + std::to_string(maxLengthAchieved);
+    std::string length_stat = "Max Length Achieved: " + std::to_string(game.maxLengthAchieved);
     mvprintw(LINES / 2 + 2, (COLS - (int)length_stat.length()) / 2, "%s", length_stat.c_str());
 
-    std::string growth_stat = "Growth Items Collected: " + std::to_string(collected_growth_items);
+    std::string growth_stat =
+        "Growth Items Collected: " + std::to_string(game.collected_growth_items);
     mvprintw(LINES / 2 + 3, (COLS - (int)growth_stat.length()) / 2, "%s", growth_stat.c_str());
 
-    std::string poison_stat = "Poison Items Touched: " + std::to_string(collected_poison_items);
+    std::string poison_stat =
+        "Poison Items Touched: " + std::to_string(game.collected_poison_items);
     mvprintw(LINES / 2 + 4, (COLS - (int)poison_stat.length()) / 2, "%s", poison_stat.c_str());
 
-    std::string gate_stat = "Gates Used: " + std::to_string(gates_used_count);
+    std::string gate_stat = "Gates Used: " + std::to_string(game.gates_used_count);
     mvprintw(LINES / 2 + 5, (COLS - (int)gate_stat.length()) / 2, "%s", gate_stat.c_str());
 
     // Ranking display logic
-    // Only after stats, before prompt
-    // Load ranking.txt, parse, sort, and find player position
-    int                     playerRank = 0;
-    std::vector<PlayerInfo> rankingList;
-    std::ifstream           rankFile("ranking.txt");
-    if (rankFile.is_open()) {
-        std::string line;
-        while (std::getline(rankFile, line)) {
-            if (line.empty())
-                continue;
-            size_t pos = line.find_last_of(' ');
-            if (pos == std::string::npos)
-                continue;
-            std::string name_str = line.substr(0, pos);
-            int         score    = std::stoi(line.substr(pos + 1));
-            rankingList.push_back({name_str, score});
-        }
-        rankFile.close();
-    }
-    std::sort(rankingList.begin(), rankingList.end(), std::greater<PlayerInfo>());
-    for (int i = 0; i < (int)rankingList.size(); ++i) {
-        if (rankingList[i].name == wstring_to_string(playerName)) {
-            playerRank = i + 1;
-            break;
-        }
+    // Only after stats, before prompt; saveRanking() already placed this game
+    if (sharedBoardReady) {
+        lastRank        = sharedBoard.rankOf(lastSequence, 1000);
+        rankedGameCount = sharedBoard.storedEntries();
     }
-    std::string rankLine = "Your Ranking: " + std::to_string(playerRank) + " / 100";
+    std::string rankLine = lastRank > 0 ? "Your Ranking: " + std::to_string(lastRank) + " / " +
+                                              std::to_string(rankedGameCount)
+                                        : "Your Ranking: unavailable";
     mvprintw(LINES / 2 + 7, (COLS - (int)rankLine.length()) / 2, "%s", rankLine.c_str());
 
     const char *return_prompt = "Press [spacebar] to return to the menu.";
@@ -1274,225 +927,314 @@ void showVictoryScreen(int finalScore) {
     }
 }
 
+// Full redraw on a new stage or after pause/resize, otherwise only the cells the engine
+// reported as changed since the last frame.
 void drawMap() {
-    erase();
-
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            move(y, x * 3);
-            int cell_type = map[y][x];
-
-            switch (cell_type) {
-            case 0:
-                addstr("   ");
-                break;
-            case 1:
-                attron(COLOR_PAIR(5));
-                addstr("███");
-                attroff(COLOR_PAIR(5));
-                break;
-            case IMMUNE_WALL:
-                attron(COLOR_PAIR(6));
-                addstr("▣▣▣");
-                attroff(COLOR_PAIR(6));
-                break;
-            case 2: // Poison Item
-                attron(COLOR_PAIR(2));
-                addstr("☠️  ");
-                attroff(COLOR_PAIR(2)); // Ensure space for multi-byte char + space
-                break;
-            case 3: // Snake Body part
-                if (!snake.empty() && y == snake.front().first &&
-                    x == snake.front().second) { // Head
-                    attron(COLOR_PAIR(3));
-                    addstr("🟨 ");
-                    attroff(COLOR_PAIR(3));
-                } else { // Body
-                    attron(COLOR_PAIR(1));
-                    addstr("🟩 ");
-                    attroff(COLOR_PAIR(1));
-                }
-                break;
-            case 4: // Growth Item
-                attron(COLOR_PAIR(3));
-                addstr("🍎 ");
-                attroff(COLOR_PAIR(3));
-                break;
-            case 5: // Gate
-                attron(COLOR_PAIR(4));
-                addstr(" 🚪 ");
-                attroff(COLOR_PAIR(4));
-                break;
-            default:
-                addstr(" ? ");
-                break;
-            }
+    bool full = game.fullRedraw || screenNeedsRedraw;
+    if (full) {
+        invalidateHud();
+        if (ansiBackend)
+            ansiScreen.clearScreen();
+        else
+            erase();
+    }
+    if (ansiBackend)
+        ansiScreen.drawBoard(game, full);
+    else
+        drawBoard(game, full);
+
+    if (full) {
+        int term_height, term_width;
+        getmaxyx(stdscr, term_height, term_width);
+        int required_width  = game.width * 3 + 40;
+        int required_height = std::max(game.height + 5, profileOverlayOn ? 34 : 0);
+
+        if (term_width < required_width || term_height < required_height) {
+            char warning[96];
+            snprintf(warning, sizeof(warning),
+                     "WARNING: Terminal too small! UI may be broken. Resize to %dx%d.",
+                     required_width, required_height);
+            overlayText(LINES - 1, 0, warning, true);
         }
+        screenNeedsRedraw = false;
     }
 
+    // A slow link gets the board every frame and the HUD a few times a second
+    if (adaptiveOn && !full && !pacer.hudDue(monotonicNs()))
+        return;
     drawScoreboard();
     drawMissionBoard();
+    if (profileOverlayOn)
+        drawProfileOverlay();
+}
 
-    int term_height, term_width;
-    getmaxyx(stdscr, term_height, term_width);
-    int required_width  = WIDTH * 3 + 40;
-    int required_height = HEIGHT + 5;
-
-    if (term_width < required_width || term_height < required_height) {
-        attron(COLOR_PAIR(2) | A_BOLD);
-        mvprintw(LINES - 1, 0, "WARNING: Terminal too small! UI may be broken. Resize to %dx%d.",
-                 required_width, required_height);
-        attroff(COLOR_PAIR(2) | A_BOLD);
+// ncurses only notices a resize inside getch(), which the game loop no longer calls.
+void checkTerminalResize() {
+    winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 &&
+        (ws.ws_row != LINES || ws.ws_col != COLS)) {
+        resizeterm(ws.ws_row, ws.ws_col);
+        screenNeedsRedraw = true;
     }
-
-    refresh();
 }
 
 void playGame() {
     // --- Comprehensive Game State Reset for a NEW GAME ---
-    gameOver       = false;
-    gameOverReason = 0; // Crucial: Reset any previous game over reason
-    gameWon        = false;
-    currentStage   = 0; // Start from the first stage (0-indexed)
-
-    // Reset scores for the new game session (already done in main(), but harmless here)
-    total_score_growth = 0;
-    total_score_poison = 0;
-    total_score_gate   = 0;
-    maxLengthAchieved  = 3; // Snake starts at length 3
-    length             = 3; // Ensure global length variable is reset to 3
-
-    // Reset current stage mission progress
-    collected_growth_items = 0;
-    collected_poison_items = 0;
-    gates_used_count       = 0;
-
-    // Reset mission status flags for display (all false initially)
-    for (int i = 0; i < STAGES; ++i) {
-        missionStatusLength[i] = false;
-        missionStatusGrowth[i] = false;
-        missionStatusPoison[i] = false;
-        missionStatusGate[i]   = false;
+    unsigned seed = rd();
+    // Seed (or the snapshot resumed from) + per-tick inputs reproduce the whole game
+    // (./snake_headless --replay)
+    Replay replay;
+    if (resumePending) {
+        beginResumedReplay(replay, game);
+    } else {
+        initGame(game, seed, boardHeight, boardWidth);
+        beginReplay(replay, game, seed);
     }
+    resumePending = false;
+    broadcaster.beginGame(wstring_to_string(playerName));
+    autopilot.reset();
+    game.autopilotUsed |= autopilotOn; // Kept in snapshots, so a resumed game stays unranked
 
-    length = 3; // Reset snake length to 3 for new game
-    // Initialize the first stage (this will handle snake placement, map, etc.)
-    initStage(currentStage);
+    // The game clock runs at the current stage's delay, independent of key presses
+    TickScheduler clock;
+    clock.start(delay_per_stage[game.currentStage]);
 
-    // Initial game speed (from the first stage's delay)
-    int DELAY = delay_per_stage[currentStage];
+    // Keys are read on their own thread and applied one turn per tick
+    InputThread input;
+    TurnQueue   turns;
+    input.start(STDIN_FILENO);
+    setOutputBlocking(false);
 
     bool isPaused = false; // Pause state variable
-
-    // Ncurses setup for game input
-    keypad(stdscr, TRUE);  // Enable arrow keys
-    nodelay(stdscr, TRUE); // Make getch() non-blocking
     curs_set(0);           // Hide cursor
-    timeout(DELAY / 1000); // Set initial input timeout
-
-    // Main game loop
-    while (!gameOver) {
-        int ch = getch();
 
-        if (ch == 'q' || ch == 'Q') {
-            // Display quitting message
-            const char *quit_msg = "Quitting game... Press any key to exit.";
-            mvprintw(HEIGHT / 2, (WIDTH * 3 + 5 - (int)strlen(quit_msg)) / 2, "%s", quit_msg);
-            refresh();
-            // Wait for any key
-            nodelay(stdscr, FALSE);
-            getch();
-            // Immediately end game loop and exit
-            gameOver = true;
-            return;
-        }
+    long long inputNs = 0; // Key handling since the last tick, for PHASE_INPUT
 
-        if (ch == 'p' || ch == 'P') {
-            isPaused = !isPaused;
-            if (isPaused) {
-                timeout(-1); // Blocking input when paused
-            } else {
-                timeout(DELAY / 1000); // Non-blocking with game delay when unpaused
+    // Main game loop: handle keys until the next tick is due, then step once
+    while (!game.gameOver) {
+        KeyEvent  event;
+        long long inputStart = monotonicNs();
+        while (!game.gameOver && input.poll(event)) {
+            if (event.key == KEY_CURSOR_REPORT) {
+                pacer.probeAnswered(event.timeNs);
+                continue;
             }
-        }
 
-        if (!isPaused) {         // --- Only update game logic if NOT paused ---
-            updateDirection(ch); // Update snake direction based on input
+            if (event.key == 'q' || event.key == 'Q') {
+                // The game can be picked up again with --resume
+                bool        saved    = saveSnapshot(game, SAVE_FILE);
+                const char *quit_msg = saved ? "Game saved. Quitting... Press any key to exit."
+                                             : "Quitting game... Press any key to exit.";
+                overlayText(game.height / 2, (game.width * 3 + 5 - (int)strlen(quit_msg)) / 2,
+                            quit_msg, false);
+                presentFrame();
+                setOutputBlocking(true);
+                settleProbe(input, true);
+                input.stop();
+                // Wait for any key
+                timeout(-1);
+                getch();
+                // Immediately end game loop and exit
+                game.gameOver       = true;
+                game.gameOverReason = 7;
+                break;
+            }
 
-            moveSnake(); // Update snake position and handle collisions/items
+            if (event.key == 'p' || event.key == 'P') {
+                isPaused          = !isPaused;
+                screenNeedsRedraw = true; // Clear the pause message
+                turns.clear();
+                if (!isPaused)
+                    clock.resync(); // Don't count the pause as a late tick
+            }
 
-            // After moveSnake(), check for game over conditions
-            if (gameOverReason != 0 || snake.size() < 3) {
-                gameOver = true;
+            if (event.key == 'a' || event.key == 'A') {
+                autopilotOn = !autopilotOn;
+                game.autopilotUsed |= autopilotOn;
+                turns.clear();
             }
 
-            // --- Insert stage advancement logic here ---
-            if (!gameOver && checkMissionClear()) {
-                // Advance to next stage immediately
-                currentStage++;
-                if (currentStage >= STAGES) {
-                    gameOver = true;
-                    gameWon  = true;
-                    break;
-                }
-                // Reset stage progress before initializing
-                collected_growth_items = 0;
-                collected_poison_items = 0;
-                gates_used_count       = 0;
-                initStage(currentStage);
-                DELAY = delay_per_stage[currentStage];
-                timeout(DELAY / 1000);
-                {
-                    clear();
-                    int max_y, max_x;
-                    getmaxyx(stdscr, max_y, max_x);
-                    std::string msg = currentStage < STAGES
-                                          ? "🎉 STAGE " + std::to_string(currentStage) +
-                                                " CLEARED! NEXT STAGE! 🎉"
-                                          : "🎉 CONGRATULATIONS! ALL STAGES CLEARED! 🎉";
-                    mvprintw(max_y / 2, (max_x - (int)msg.length()) / 2, "%s", msg.c_str());
-                    refresh();
-                    usleep(3000000); // Pause for 3 seconds before next stage
-                }
-                continue; // Skip rendering this frame to start next stage cleanly
+            if (event.key == 't' || event.key == 'T') {
+                profileOverlayOn  = !profileOverlayOn;
+                screenNeedsRedraw = true; // Clear the overlay's rows
             }
+
+            int dir = keyToDirection(event.key);
+            if (dir != NO_INPUT && !isPaused && !autopilotOn)
+                turns.push(dir, event.timeNs, game.dirIndex);
         }
+        inputNs += monotonicNs() - inputStart;
 
-        // Only proceed if game is not over
-        if (!gameOver) {
-            drawMap();          // Draw the game map
-            drawScoreboard();   // Draw player scores
-            drawMissionBoard(); // Draw mission objectives
+        if (game.gameOver)
+            break;
+        checkTerminalResize();
 
+        // Pause toggles and resizes show up right away, not at the next tick
+        if (screenNeedsRedraw) {
+            drawMap();
             // --- Display PAUSED message if applicable ---
             if (isPaused) {
                 const char *pause_msg = "PAUSED - Press 'P' to resume";
-                mvprintw(HEIGHT / 2, (WIDTH / 2) - (strlen(pause_msg) / 2), "%s", pause_msg);
+                overlayText(game.height / 2, (game.width / 2) - (strlen(pause_msg) / 2),
+                            pause_msg, false);
+            }
+            presentFrame();
+        }
+
+        if (isPaused || !clock.due()) {
+            clock.waitUntilDue(INPUT_CHECK_NS); // Wake up now and then for pause/quit
+            continue;
+        }
+
+        // --- Tick ---
+        clock.beginTick();
+        tickProfile.beginTick();
+        long long budgetNs = delay_per_stage[game.currentStage] * 1000LL; // Before a stage change
+        tickProfile.phases[PHASE_INPUT].record(inputNs);
+        inputNs  = 0;
+        int turn = autopilotOn ? autopilot.choose(game) : turns.pop(monotonicNs());
+        recordTick(replay, turn);
+        tickProfile.lap(PHASE_TURN);
+        StepResult result = step(game, turn);
+        broadcaster.publish(game, highScore);
+        tickProfile.lap(PHASE_STEP);
+
+        if (result == STEP_GAME_WON) {
+            tickProfile.endTick(budgetNs);
+            break;
+        }
+
+        if (result == STEP_STAGE_CLEAR) {
+            tickProfile.endTick(budgetNs); // The banner below isn't part of the tick
+            saveSnapshot(game, CHECKPOINT_FILE); // --resume checkpoint.snks retries this stage
+            setOutputBlocking(true);
+            settleProbe(input, false);
+            clear();
+            int max_y, max_x;
+            getmaxyx(stdscr, max_y, max_x);
+            std::string msg =
+                "🎉 STAGE " + std::to_string(game.currentStage) + " CLEARED! NEXT STAGE! 🎉";
+            mvprintw(max_y / 2, (max_x - (int)msg.length()) / 2, "%s", msg.c_str());
+            refresh();
+            usleep(3000000); // Pause for 3 seconds before next stage
+            input.discard(); // Drop keys pressed during the banner
+            pacer.forgetProbe();
+            turns.clear();
+            tickStats.merge(clock.stats);
+            clock = TickScheduler();
+            clock.start(delay_per_stage[game.currentStage]);
+            setOutputBlocking(false);
+            continue; // Skip rendering this frame to start next stage cleanly
+        }
+
+        // A frame the terminal can't take yet is skipped; its cells stay in the damage list
+        bool drawFrame = true;
+        if (adaptiveOn && !game.gameOver) {
+            long long queued = ansiScreen.pending.size() + terminalBacklog(STDOUT_FILENO);
+            drawFrame        = pacer.frameDue(monotonicNs(), queued,
+                                              delay_per_stage[game.currentStage] * 1000LL);
+            if (pacer.compact != ansiScreen.compact) {
+                ansiScreen.compact = pacer.compact;
+                screenNeedsRedraw  = true;
             }
+        }
 
-            // (Stage advancement logic moved above, after moveSnake)
-            refresh(); // Update the physical screen
+        // Only proceed if game is not over
+        if (!game.gameOver && drawFrame) {
+            drawMap(); // Draw the game map, scoreboard and mission board
+            tickProfile.lap(PHASE_DRAW);
+            presentFrame(); // Update the physical screen
+            tickProfile.lap(PHASE_REFRESH);
         }
+        // Every tick counts, skipped frames and the last one included
+        tickProfile.endTick(budgetNs);
     }
+    setOutputBlocking(true);
+    settleProbe(input, true);
+    input.stop();
+    if (ansiBackend)
+        clearok(curscr, TRUE); // ncurses' idea of the screen is stale; repaint it all next time
+    tickStats.merge(clock.stats);
+    turnStats.mergeStats(turns);
+    droppedKeys += input.droppedKeys();
+    broadcaster.endGame(game);
+
+    if (game.gameOverReason == 7)
+        return; // Quit: nothing is recorded
 
     // Game loop exited (game over or game won)
     nodelay(stdscr, FALSE); // Make getch() blocking again for game over screen
     curs_set(1);            // Show cursor
 
-    int finalScore =
-        (int)snake.size() * 100 + total_score_growth - total_score_poison + total_score_gate;
-    saveHighScore(finalScore);
-    saveRanking(playerName, finalScore);
+    int score = finalScore(game);
+    if (game.autopilotUsed) {
+        lastRank     = -1;
+        lastSequence = NO_SEQUENCE;
+    } else {
+        saveHighScore(score);
+        saveRanking(playerName, score);
+    }
+    finishReplay(replay, game);
+    saveReplay(replay, LAST_REPLAY_FILE);
 
-    if (gameWon)
-        showVictoryScreen(finalScore);
+    if (game.gameWon)
+        showVictoryScreen(score);
     else
-        showGameOverScreen(finalScore);
+        showGameOverScreen(score);
 }
 
-int main() {
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--board") == 0 && i + 1 < argc &&
+            parseBoardSize(argv[i + 1], boardHeight, boardWidth)) {
+            ++i;
+        } else if (strcmp(argv[i], "--tick-stats") == 0) {
+            printTickStats = true;
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilotOn = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profileOverlayOn = true;
+        } else if (strcmp(argv[i], "--adaptive") == 0) {
+            adaptiveOn  = true;
+            ansiBackend = true;
+        } else if (strcmp(argv[i], "--broadcast") == 0) {
+            bool named    = i + 1 < argc && argv[i + 1][0] != '-';
+            broadcastPath = named ? argv[++i] : DEFAULT_WATCH_SOCKET;
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            bool named = i + 1 < argc && argv[i + 1][0] != '-';
+            resumePath = named ? argv[++i] : SAVE_FILE;
+        } else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc &&
+                   (strcmp(argv[i + 1], "ansi") == 0 || strcmp(argv[i + 1], "curses") == 0)) {
+            ansiBackend = strcmp(argv[++i], "ansi") == 0;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--board HxW] [--tick-stats] [--autopilot] [--profile] "
+                    "[--render curses|ansi] [--adaptive] [--broadcast [SOCKET]] [--resume [FILE]]  "
+                    "(%d..%d per side, default %dx%d)\n",
+                    argv[0], MIN_BOARD_SIZE, MAX_BOARD_SIZE, DEFAULT_HEIGHT, DEFAULT_WIDTH);
+            return 1;
+        }
+    }
+
+    if (resumePath) {
+        resumePending = loadSnapshot(game, resumePath) && !game.gameOver;
+        if (!resumePending) {
+            fprintf(stderr, "snake_game: can't resume from %s\n", resumePath);
+            return 1;
+        }
+        boardHeight = game.height; // Later games keep the saved game's board
+        boardWidth  = game.width;
+    }
+
+    if (broadcastPath) {
+        signal(SIGPIPE, SIG_IGN); // A spectator that hangs up is just dropped
+        if (!broadcaster.start(broadcastPath)) {
+            fprintf(stderr, "snake_game: can't listen on %s\n", broadcastPath);
+            return 1;
+        }
+    }
+
     setlocale(LC_ALL, ""); // For Unicode characters
-    srand(time(0));        // Seed random number generator
 
     initscr();            // Initialize ncurses
     cbreak();             // Disable line buffering
@@ -1508,6 +1250,8 @@ int main() {
     }
     initColors(); // Initialize color pairs
 
+    sharedBoardReady = sharedBoard.attach(); // Falls back to the files alone if it can't
+
     loadHighScore(); // Load high score from file
 
     while (true) {
@@ -1519,23 +1263,45 @@ int main() {
                 if (playerName.empty())
                     playerName = L"Player"; // Default if empty
             }
-            // Reset game-wide scores before starting a new game session
-            total_score_growth     = 0;
-            total_score_poison     = 0;
-            total_score_gate       = 0;
-            maxLengthAchieved      = 3; // Initial length
-            currentStage           = 0;
-            collected_growth_items = 0;
-            collected_poison_items = 0;
-            gates_used_count       = 0;
-
-            playGame();                // Start game loop
+            playGame();                // Start game loop (resets all game state)
         } else if (menu_choice == 0) { // "Exit" was chosen
             break;                     // Exit the main menu loop and terminate
         }
         // If "Game Rules" or "Ranking" was chosen, showMenuScreen handles them and returns to menu
     }
 
+    sharedBoard.waitForPersist();
+    broadcaster.stop();
     endwin(); // De-initialize ncurses
+
+    if (tickProfile.phases[PHASE_TICK].total > 0)
+        tickProfile.writeFile(TICK_PROFILE_FILE, "snake_game tick phase latencies, budget = "
+                                                 "the stage's tick delay");
+
+    if (printTickStats) {
+        printf("ticks: %lld  jitter mean: %.1f us  max: %.1f us  late (>=1ms): %lld  "
+               "resyncs: %lld\n",
+               tickStats.ticks, tickStats.meanUs(), tickStats.maxUs(), tickStats.lateTicks,
+               tickStats.resyncs);
+        printf("turns: %lld  input latency mean: %.1f us  max: %.1f us  dropped turns: %lld  "
+               "dropped keys: %lld\n",
+               turnStats.applied, turnStats.meanLatencyUs(), turnStats.maxLatencyNs / 1000.0,
+               turnStats.dropped, droppedKeys);
+        if (ansiBackend)
+            printf("ansi frames: %lld  bytes per frame mean: %.0f  max: %lld  write() calls "
+                   "per frame: %.2f\n",
+                   ansiScreen.stats.frames, ansiScreen.stats.bytesPerFrame(),
+                   ansiScreen.stats.maxBytes, ansiScreen.stats.writesPerFrame());
+        if (adaptiveOn)
+            printf("adaptive: frames drawn: %lld  dropped: %lld  ascii fallbacks: %lld  "
+                   "link: %.1f KB/s  rtt: %.1f ms%s\n",
+                   pacer.drawn, pacer.dropped, pacer.fallbacks, pacer.rate / 1000,
+                   pacer.baseRttNs / 1e6, pacer.answering ? "" : "  (no DSR answers)");
+        if (broadcastPath)
+            printf("broadcast: messages: %lld  keyframes: %lld  bytes: %lld  queue overflows: "
+                   "%lld  peak spectators: %lld  resyncs: %lld\n",
+                   broadcaster.messages, broadcaster.keyframes, broadcaster.bytes,
+                   broadcaster.overflows, broadcaster.peakSpectators, broadcaster.resyncs);
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,221 @@
+// snake_headless.cpp - ncurses 없이 엔진만 돌리는 시뮬레이터
+// 간단한 회피 정책으로 게임을 반복 실행하고 초당 틱 수를 출력한다.
+// Run: ./snake_headless [ticks] [seed] [HxW] [--autopilot]
+//      ./snake_headless --replay FILE [repeat]
+//      ./snake_headless --check [games] [seed] [HxW]  (매 틱 인덱스/아이템 불변식 검사)
+
+#include "autopilot.h"
+#include "replay.h"
+#include "snake_engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4] = {0, 0, -1, 1};
+
+// The policy draws from its own stream so it never perturbs the game's RNG.
+static GameRng policyRng;
+
+// Straight ahead if safe, otherwise a random safe side turn.
+static int choosePolicyDirection(const GameState &state) {
+    static const int turns[4][2] = {{LEFT, RIGHT}, {LEFT, RIGHT}, {UP, DOWN}, {UP, DOWN}};
+
+    int  candidates[3] = {state.dirIndex, turns[state.dirIndex][0], turns[state.dirIndex][1]};
+    bool flip          = policyRng() & 1;
+    if (flip)
+        std::swap(candidates[1], candidates[2]);
+
+    for (int d : candidates) {
+        int y = state.headY + dy[d];
+        int x = state.headX + dx[d];
+        if (y < 0 || y >= state.height || x < 0 || x >= state.width)
+            continue;
+        int cell = cellAt(state, y, x);
+        if (cell == CELL_EMPTY || cell == CELL_GROWTH ||
+            (cell == CELL_POISON && state.snake.size() > 3) ||
+            (cell == CELL_GATE && !gateOnCooldown(state)))
+            return d;
+    }
+    return NO_INPUT;
+}
+
+// Re-simulates a recorded game `repeat` times as fast as possible.
+static int playReplayFile(const char *path, int repeat) {
+    Replay replay;
+    if (!loadReplay(replay, path)) {
+        fprintf(stderr, "cannot read replay %s\n", path);
+        return 1;
+    }
+
+    GameState state;
+    bool      match = true;
+    auto      start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        match = playReplay(replay, state) && match;
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("replay: %s  board: %dx%d  seed: %u  ticks: %lld  inputs: %zu\n", path, replay.height,
+           replay.width, replay.seed, replay.ticks, replay.inputs.size());
+    if (!replay.start.empty())
+        printf("resumed from a %zu-byte snapshot\n", replay.start.size());
+    printf("recorded: score %d  reason %d  stage %d%s\n", replay.finalScore,
+           replay.gameOverReason, replay.stage + 1, replay.won ? "  won" : "");
+    printf("replayed: score %d  reason %d  stage %d%s\n", finalScore(state), state.gameOverReason,
+           state.currentStage + 1, state.gameWon ? "  won" : "");
+    printf("elapsed: %.3f s for %d runs  (%.2f M ticks/s)\n", seconds, repeat,
+           replay.ticks * (double)repeat / seconds / 1e6);
+    printf("%s\n", match ? "MATCH" : "MISMATCH");
+    return match ? 0 : 2;
+}
+
+// First broken invariant between the board and the indexes kept beside it, or null.
+static const char *brokenInvariant(const GameState &state) {
+    int area = state.height * state.width, empty = 0, growth = 0, poison = 0;
+    for (int cell = 0; cell < area; ++cell) {
+        int value = state.map[cell];
+        empty += value == CELL_EMPTY;
+        growth += value == CELL_GROWTH;
+        poison += value == CELL_POISON;
+        if ((value == CELL_EMPTY) != state.freeCells.contains(cell))
+            return "freeCells out of sync with the map";
+    }
+    if (empty != state.freeCells.size())
+        return "freeCells size";
+    if (growth != state.growthItemCount || poison != state.poisonItemCount)
+        return "item counters out of sync with the map";
+    if (state.itemCount != growth + poison)
+        return "itemCount != growth + poison items";
+    if (growth > state.rules->maxGrowthItems || poison > state.rules->maxPoisonItems)
+        return "item cap exceeded";
+    for (int i = 0; i < state.itemCount; ++i) {
+        int value = state.map[state.items[i].cell];
+        if (value != CELL_GROWTH && value != CELL_POISON)
+            return "listed item is not on the board";
+        if (!state.timers.active(state.items[i].timer))
+            return "listed item has no expiry timer";
+    }
+    int body = 0;
+    state.snake.forEach([&](CellIndex cell) { body += state.map[cell] == CELL_SNAKE; });
+    if (body != state.snake.size())
+        return "snake segment not on the board";
+    return nullptr;
+}
+
+// Seeded autopilot games checked after every tick; exits non-zero at the first broken one.
+static int checkGames(long long games, unsigned seed, int height, int width) {
+    GameState state;
+    Autopilot autopilot;
+    long long ticks = 0;
+    for (long long game = 0; game < games; ++game) {
+        unsigned gameSeed = seed + (unsigned)game;
+        initGame(state, gameSeed, height, width);
+        autopilot.reset();
+        for (long long tick = 1; !state.gameOver; ++tick, ++ticks) {
+            step(state, autopilot.choose(state));
+            if (const char *broken = brokenInvariant(state)) {
+                printf("seed %u tick %lld: %s (itemCount %d, growth %d, poison %d)\n", gameSeed,
+                       tick, broken, state.itemCount, state.growthItemCount,
+                       state.poisonItemCount);
+                return 2;
+            }
+        }
+    }
+    printf("check: %lld games, %lld ticks on %dx%d from seed %u: OK\n", games, ticks, height,
+           width, seed);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0)
+        return playReplayFile(argv[2], argc > 3 ? atoi(argv[3]) : 1);
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+        int height = DEFAULT_HEIGHT, width = DEFAULT_WIDTH;
+        if (argc > 4 && !parseBoardSize(argv[4], height, width)) {
+            fprintf(stderr, "board size must be HxW with %d..%d per side\n", MIN_BOARD_SIZE,
+                    MAX_BOARD_SIZE);
+            return 1;
+        }
+        return checkGames(argc > 2 ? atoll(argv[2]) : 2000,
+                          argc > 3 ? (unsigned)strtoul(argv[3], nullptr, 10) : 17000, height,
+                          width);
+    }
+
+    // --autopilot may appear anywhere; the rest are positional
+    bool useAutopilot = false;
+    int  positional   = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--autopilot") == 0)
+            useAutopilot = true;
+        else
+            argv[positional++] = argv[i];
+    }
+    argc = positional;
+
+    long long totalTicks = argc > 1 ? atoll(argv[1]) : 10000000LL;
+    unsigned  seed       = argc > 2 ? (unsigned)strtoul(argv[2], nullptr, 10) : 1;
+    int       height = DEFAULT_HEIGHT, width = DEFAULT_WIDTH;
+    if (argc > 3 && !parseBoardSize(argv[3], height, width)) {
+        fprintf(stderr, "board size must be HxW with %d..%d per side\n", MIN_BOARD_SIZE,
+                MAX_BOARD_SIZE);
+        return 1;
+    }
+
+    GameState state;
+    policyRng.seed(seed, 1);
+    initGame(state, seed, height, width);
+
+    long long games = 0, wins = 0;
+    long long reasons[8]            = {0};
+    long long stagesReached[STAGES] = {0};
+
+    Autopilot autopilot;
+    long long planNs = 0, planMaxNs = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 0; tick < totalTicks; ++tick) {
+        int input;
+        if (useAutopilot) {
+            auto planStart = std::chrono::steady_clock::now();
+            input          = autopilot.choose(state);
+            long long ns   = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - planStart)
+                               .count();
+            planNs += ns;
+            planMaxNs = std::max(planMaxNs, ns);
+        } else {
+            input = choosePolicyDirection(state);
+        }
+        StepResult result = step(state, input);
+        if (result == STEP_GAME_OVER || result == STEP_GAME_WON) {
+            games++;
+            if (result == STEP_GAME_WON)
+                wins++;
+            else
+                reasons[state.gameOverReason & 7]++;
+            stagesReached[state.currentStage < STAGES ? state.currentStage : STAGES - 1]++;
+            initGame(state, seed + (unsigned)games, height, width);
+        }
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("board: %dx%d\n", height, width);
+    printf("ticks: %lld  games: %lld  wins: %lld\n", totalTicks, games, wins);
+    printf("elapsed: %.3f s  (%.2f M ticks/s)\n", seconds, totalTicks / seconds / 1e6);
+    printf("game over reasons:");
+    for (int i = 1; i < 8; ++i)
+        printf(" [%d]=%lld", i, reasons[i]);
+    printf("\nstage reached:");
+    for (int i = 0; i < STAGES; ++i)
+        printf(" [%d]=%lld", i + 1, stagesReached[i]);
+    printf("\n");
+    if (useAutopilot)
+        printf("autopilot: %.1f us/tick avg, %.3f ms max, %lld full rebuilds, %lld incremental\n",
+               planNs / 1000.0 / totalTicks, planMaxNs / 1e6, autopilot.fullRebuilds,
+               autopilot.incrementalUpdates);
+    return 0;
+}
@@ -0,0 +1,322 @@
+// snake_scaling.cpp - 보드 크기 x 뱀 길이 스케일링 벤치마크
+// 보드 크기(21x21 ~ 1024x1024)와 채움 비율(뱀 길이 / 안쪽 칸 수)의 격자마다 엔진을 헤드리스로
+// 돌려서 틱, 아이템 생성, 게이트 재생성, 그리기(AnsiRenderer) 비용을 재고 CSV 로 쓴다.
+// 뱀은 안쪽 칸을 한 번씩 지나는 해밀턴 순환을 따라 움직이므로 길이가 보드를 거의 채워도 죽지 않는다.
+// 마지막에 지표마다 보드 넓이에 대한 로그-로그 기울기를 stderr 로 출력하고, 기울기가
+// SCALING_MAX_SLOPE 를 넘는 지표(= 넓이에 비례하는 숨은 스캔)를 표시한다.
+// 틱/생성 시간은 한 번씩 잰 값이라 시계 읽기 한 번(수십 ns)이 포함된다.
+// Run: ./snake_scaling [--csv FILE] [--ticks N] [--boards 21,81,...] [--fills 0,0.5,...]
+//      (make scaling)
+
+#include "ansi_renderer.h"
+#include "snake_engine.h"
+#include "tick_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define SCALING_TICKS 20000   // Ticks timed at each point
+#define SCALING_SPAWNS 20000  // Item spawns timed at each point
+#define SCALING_GATES 2000    // Gate respawns timed at each point
+#define SCALING_MAX_SLOPE 0.5 // Growth with board area beyond area^this is flagged
+
+static const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4] = {0, 0, -1, 1};
+
+// No inner walls, missions and turn limits out of reach: only the snake's length decides
+// how full the board is.
+static const GameRules &scalingRules() {
+    static GameRules rules = [] {
+        GameRules r = defaultRules;
+        for (int s = 0; s < STAGES; ++s) {
+            r.layoutPerStage[s]           = LAYOUT_SCATTER;
+            r.innerWallProbability[s]     = 0;
+            r.stageTurnLimitPerStage[s]   = 1 << 30;
+            r.mission_length_per_stage[s] = 1 << 30;
+        }
+        return r;
+    }();
+    return rules;
+}
+
+// A Hamiltonian cycle over the inner rows 1..R (R even, so the last inner row is left out
+// on odd boards) and columns 1..W-2: right along row 1, back and forth over columns 2..W-2
+// in the rows below, then up column 1.
+static std::vector<int> buildCycle(int height, int width) {
+    const int        R = (height - 2) & ~1;
+    const int        C = width - 2;
+    std::vector<int> cycle;
+    cycle.reserve(R * C);
+    for (int x = 1; x <= C; ++x)
+        cycle.push_back(1 * width + x);
+    for (int y = 2; y <= R; ++y) {
+        if (y % 2 == 0)
+            for (int x = C; x >= 2; --x)
+                cycle.push_back(y * width + x);
+        else
+            for (int x = 2; x <= C; ++x)
+                cycle.push_back(y * width + x);
+    }
+    for (int y = R; y >= 2; --y)
+        cycle.push_back(y * width + 1);
+    return cycle;
+}
+
+// Direction from each cycle cell to the next one.
+static std::vector<std::uint8_t> cycleDirections(const std::vector<int> &cycle, int height,
+                                                 int width) {
+    std::vector<std::uint8_t> dirs(height * width, 0);
+    for (size_t i = 0; i < cycle.size(); ++i) {
+        int from = cycle[i], to = cycle[(i + 1) % cycle.size()];
+        for (int d = 0; d < 4; ++d)
+            if (from + dy[d] * width + dx[d] == to)
+                dirs[from] = (std::uint8_t)d;
+    }
+    return dirs;
+}
+
+// New game whose snake covers the first `length` cells of the cycle, with the usual
+// first items and gates.
+static void setupBoard(GameState &state, int size, unsigned seed, const std::vector<int> &cycle,
+                       int length) {
+    initGame(state, seed, size, size, scalingRules());
+    while (state.itemCount > 0)
+        removeItem(state, state.items[0].cell);
+    state.snake.forEach([&state](CellIndex cell) { setCell(state, cell, CELL_EMPTY); });
+    state.snake.clear();
+
+    for (int i = length - 1; i >= 0; --i) {
+        state.snake.pushBack((CellIndex)cycle[i]);
+        setCell(state, cycle[i], CELL_SNAKE);
+    }
+    int head = cycle[length - 1], neck = cycle[length - 2];
+    state.headY = head / size;
+    state.headX = head % size;
+    for (int d = 0; d < 4; ++d)
+        if (neck + dy[d] * size + dx[d] == head)
+            state.dirIndex = state.prevDirIndex = d;
+    state.fullRedraw = true;
+
+    spawnGrowthItem(state);
+    spawnPoisonItem(state);
+    spawnGates(state);
+}
+
+struct ScalingPoint {
+    int              board    = 0;
+    double           fill     = 0;
+    int              length   = 0, freeCells = 0, gateCandidates = 0;
+    long long        restarts = 0;
+    LatencyHistogram tick, spawn, gate;
+    double           damageNs = 0, damageBytes = 0; // Per tick
+    double           fullNs = 0, fullBytes = 0;     // Per full frame
+};
+
+static ScalingPoint measurePoint(int size, double fill, int ticks) {
+    ScalingPoint point;
+    point.board = size;
+    point.fill  = fill;
+
+    std::vector<int>          cycle = buildCycle(size, size);
+    std::vector<std::uint8_t> dirs  = cycleDirections(cycle, size, size);
+    int      length = std::max(3, std::min((int)cycle.size() - 2, (int)(fill * cycle.size())));
+    unsigned seed   = 1;
+
+    GameState state;
+    setupBoard(state, size, seed, cycle, length);
+    AnsiRenderer renderer;
+    renderer.drawBoard(state, true);
+
+    // Ticks along the cycle, each followed by a damage frame. Growth and poison items keep
+    // the length near `length`; a snake that grew into its tail or shrank below 3 starts over.
+    long long lengthSum = 0;
+    for (int i = 0; i < ticks; ++i) {
+        long long  start   = monotonicNs();
+        StepResult result  = step(state, dirs[state.snake.at(0)]);
+        long long  stepped = monotonicNs();
+        renderer.reset();
+        renderer.drawBoard(state, false);
+        long long drawn = monotonicNs();
+
+        point.tick.record(stepped - start);
+        point.damageNs += drawn - stepped;
+        point.damageBytes += renderer.out.size();
+        lengthSum += state.snake.size();
+        if (result == STEP_GAME_OVER) {
+            point.restarts++;
+            setupBoard(state, size, ++seed, cycle, length);
+            renderer.drawBoard(state, true);
+        }
+    }
+    point.damageNs /= ticks;
+    point.damageBytes /= ticks;
+    point.length = (int)(lengthSum / ticks);
+
+    // Spawns on the board as the ticks left it, without the live items so there's room
+    while (state.itemCount > 0)
+        removeItem(state, state.items[0].cell);
+    point.freeCells = state.freeCells.size();
+    for (int i = 0; i < SCALING_SPAWNS && !state.freeCells.empty(); ++i) {
+        long long start = monotonicNs();
+        int       cell  = spawnGrowthItem(state);
+        point.spawn.record(monotonicNs() - start);
+        removeItem(state, cell);
+    }
+
+    point.gateCandidates = state.gateCandidates.size();
+    for (int i = 0; i < SCALING_GATES; ++i) {
+        long long start = monotonicNs();
+        spawnGates(state);
+        point.gate.record(monotonicNs() - start);
+    }
+
+    // Enough full frames for a stable time without spending long on the big boards
+    int       frames = std::max(2, 2000000 / (size * size));
+    long long start  = monotonicNs();
+    for (int i = 0; i < frames; ++i) {
+        renderer.reset();
+        renderer.drawBoard(state, true);
+        point.fullBytes = renderer.out.size();
+    }
+    point.fullNs = (double)(monotonicNs() - start) / frames;
+    return point;
+}
+
+static void writeCsv(FILE *out, const std::vector<ScalingPoint> &points) {
+    fprintf(out, "board,fill,length,free_cells,gate_candidates,restarts,"
+                 "tick_mean_ns,tick_p50_ns,tick_p99_ns,tick_max_ns,"
+                 "spawn_mean_ns,spawn_p99_ns,spawn_max_ns,gate_mean_ns,gate_p99_ns,gate_max_ns,"
+                 "damage_frame_ns,damage_frame_bytes,full_frame_ns,full_frame_bytes\n");
+    for (const ScalingPoint &p : points) {
+        fprintf(out, "%d,%g,%d,%d,%d,%lld,", p.board, p.fill, p.length, p.freeCells,
+                p.gateCandidates, p.restarts);
+        fprintf(out, "%.1f,%lld,%lld,%lld,", p.tick.meanUs() * 1000, p.tick.percentileNs(0.50),
+                p.tick.percentileNs(0.99), p.tick.maxNs);
+        fprintf(out, "%.1f,%lld,%lld,", p.spawn.meanUs() * 1000, p.spawn.percentileNs(0.99),
+                p.spawn.maxNs);
+        fprintf(out, "%.1f,%lld,%lld,", p.gate.meanUs() * 1000, p.gate.percentileNs(0.99),
+                p.gate.maxNs);
+        fprintf(out, "%.1f,%.1f,%.1f,%.0f\n", p.damageNs, p.damageBytes, p.fullNs, p.fullBytes);
+    }
+}
+
+// Log-log slope of each per-operation cost against board area, smallest board to largest,
+// at every fill level. O(1) work stays near 0 (cache misses add a little on big boards);
+// a scan over the board shows up near 1.
+static int reportSlopes(const std::vector<ScalingPoint> &points, const std::vector<int> &boards,
+                        const std::vector<double> &fills) {
+    struct Metric {
+        const char *name;
+        double (*value)(const ScalingPoint &);
+    };
+    static const Metric metrics[] = {
+        {"tick_mean", [](const ScalingPoint &p) { return p.tick.meanUs(); }},
+        {"tick_p99", [](const ScalingPoint &p) { return (double)p.tick.percentileNs(0.99); }},
+        {"spawn_mean", [](const ScalingPoint &p) { return p.spawn.meanUs(); }},
+        {"gate_mean", [](const ScalingPoint &p) { return p.gate.meanUs(); }},
+        {"damage_frame", [](const ScalingPoint &p) { return p.damageNs; }},
+    };
+    if (boards.size() < 2)
+        return 0;
+
+    fprintf(stderr, "\nslope of log(cost) over log(area), board %d -> %d (flagged above %.2f)\n",
+            boards.front(), boards.back(), SCALING_MAX_SLOPE);
+    fprintf(stderr, "%6s", "fill");
+    for (const Metric &m : metrics)
+        fprintf(stderr, " %13s", m.name);
+    fprintf(stderr, "\n");
+
+    int flagged = 0;
+    for (size_t f = 0; f < fills.size(); ++f) {
+        // Points are stored board by board, fill by fill
+        const ScalingPoint &small     = points[f];
+        const ScalingPoint &large     = points[(boards.size() - 1) * fills.size() + f];
+        double              areaRatio = 2 * std::log((double)large.board / small.board);
+        fprintf(stderr, "%6g", fills[f]);
+        for (const Metric &m : metrics) {
+            double a     = m.value(small), b = m.value(large);
+            double slope = a > 0 && b > 0 ? std::log(b / a) / areaRatio : 0;
+            bool   hot   = slope > SCALING_MAX_SLOPE;
+            flagged += hot;
+            fprintf(stderr, " %12.2f%s", slope, hot ? "!" : " ");
+        }
+        fprintf(stderr, "\n");
+    }
+    if (flagged)
+        fprintf(stderr, "%d cost(s) grow with the board area (marked !)\n", flagged);
+    return flagged;
+}
+
+// Comma-separated list of numbers into `out`; false on anything else.
+template <typename T> static bool parseList(const char *text, std::vector<T> &out) {
+    out.clear();
+    while (*text) {
+        char  *end;
+        double value = strtod(text, &end);
+        if (end == text)
+            return false;
+        out.push_back((T)value);
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',')
+            return false;
+    }
+    return !out.empty();
+}
+
+int main(int argc, char **argv) {
+    std::vector<int>    boards = {21, 41, 81, 161, 256, 512, 1024};
+    std::vector<double> fills  = {0, 0.25, 0.5, 0.75, 0.9, 0.99};
+    const char         *csvPath = nullptr;
+    int                 ticks   = SCALING_TICKS;
+
+    for (int i = 1; i < argc; ++i) {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--csv") == 0) {
+            csvPath = argv[++i];
+        } else if (ok && strcmp(argv[i], "--ticks") == 0) {
+            ticks = atoi(argv[++i]);
+            ok    = ticks > 0;
+        } else if (ok && strcmp(argv[i], "--boards") == 0) {
+            ok = parseList(argv[++i], boards);
+            for (int size : boards)
+                ok = ok && size >= MIN_BOARD_SIZE && size <= MAX_BOARD_SIZE;
+        } else if (ok && strcmp(argv[i], "--fills") == 0) {
+            ok = parseList(argv[++i], fills);
+            for (double fill : fills)
+                ok = ok && fill >= 0 && fill <= 1;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr,
+                    "usage: %s [--csv FILE] [--ticks N] [--boards 21,81,...] [--fills 0,0.5,...]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    std::sort(boards.begin(), boards.end());
+
+    std::vector<ScalingPoint> points;
+    for (int size : boards) {
+        for (double fill : fills) {
+            fprintf(stderr, "  board=%d fill=%g\n", size, fill);
+            points.push_back(measurePoint(size, fill, ticks));
+        }
+    }
+
+    FILE *out = csvPath ? fopen(csvPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "can't write %s\n", csvPath);
+        return 1;
+    }
+    writeCsv(out, points);
+    if (csvPath)
+        fclose(out);
+    reportSlopes(points, boards, fills);
+    return 0;
+}
@@ -0,0 +1,629 @@
+// snake_server.cpp - 한 프로세스에서 여러 게임 세션을 돌리는 아케이드 서버
+// 플레이어는 유닉스 소켓(snake_server.sock)으로 접속하거나, --ptys N 으로 열어 둔 가상
+// 터미널에 붙는다. ncurses 는 터미널 하나만 다룰 수 있고 스레드 안전하지도 않으므로
+// 세션마다 ANSI 렌더러로 프레임을 만들어 write() 한 번으로 보낸다.
+//
+// 메인 스레드: 접속을 받고 입력 바이트를 키로 풀어 세션의 SPSC 링에 넣은 뒤, 입력이 왔거나
+//             마감 시각이 된 세션을 작업 훔치기 풀에 넘긴다.
+// 작업자:     세션 하나를 맡아 키를 처리하고, 틱이 되었으면 step() + 렌더링 + 전송을 한다.
+//             세션은 자기 스테이지의 delay_per_stage 간격으로 제각기 돈다.
+// 끝난 게임은 공유 랭킹(ranking.shm)에 들어가므로 snake_game 과 같은 순위표를 쓴다.
+// 게임 중에 'q' 로 나가면 그 판을 스냅샷으로 이름별로 보관했다가 같은 이름으로 들어오면 이어서
+// 하게 한다. 스테이지를 넘길 때마다 스냅샷을 떠 두므로, 게임 오버 화면에서 그 스테이지를 처음부터
+// 다시 할 수도 있다.
+//
+// Run:  ./snake_server [--socket PATH] [--ptys N] [--threads N] [--board HxW] [--report SEC]
+// Play: socat -,raw,echo=0 UNIX-CONNECT:snake_server.sock
+
+#include "ansi_renderer.h"
+#include "input_thread.h"
+#include "shared_leaderboard.h"
+#include "snake_engine.h"
+#include "snapshot.h"
+#include "tick_scheduler.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#define DEFAULT_SOCKET_PATH "snake_server.sock"
+#define MAX_SESSIONS        1000
+#define MAX_NAME_LENGTH     30
+#define MAX_PENDING_OUTPUT  (256 * 1024) // Unsent bytes kept for a slow client
+#define STAGE_BANNER_NS     3000000000LL // Stage clear banner, as in snake_game
+#define RANK_POLL_NS        200000000LL  // Game over screen checks for its rank
+#define IDLE_WAKE_NS        (1LL << 62)  // Nothing to do until a key arrives
+#define MAIN_POLL_NS        50000000LL
+#define MAX_SAVED_BYTES     (64 * 1024 * 1024) // Snapshots kept for players who quit, in all
+
+enum SessionPhase {
+    PHASE_NAME = 0, // Typing a name
+    PHASE_PLAYING,
+    PHASE_BANNER, // Stage clear banner
+    PHASE_OVER,   // Game over / victory screen
+};
+
+struct Session {
+    int  id;
+    int  fd;
+    int  ptySlaveFd = -1; // Held open so the pty stays up between players
+    bool isPty      = false;
+
+    // Shared between the main thread and whichever worker runs the session
+    std::atomic<long long>             wakeNs{0};        // Run again at this time
+    std::atomic<bool>                  scheduled{false}; // Queued or running on the pool
+    std::atomic<bool>                  closing{false};   // Disconnected or quit
+    SpscRing<KeyEvent, KEY_QUEUE_SIZE> keys;             // Main thread -> worker
+    KeyDecoder                         decoder;          // Main thread only
+
+    // Worker side; only one worker touches these at a time
+    SessionPhase  phase = PHASE_NAME;
+    std::string   name;
+    GameState     game;
+    TickScheduler clock;
+    TurnQueue     turns;
+    AnsiRenderer  screen;
+    std::string   pending; // Frame bytes the client hasn't taken yet
+    bool          paused      = false;
+    bool          fullRedraw  = true;
+    std::uint32_t sequence    = NO_SEQUENCE;
+    long long     rank        = -1;
+    long long     bannerEndNs = 0;
+
+    std::vector<std::uint8_t> checkpoint; // Snapshot at the start of the current stage
+
+    // Tick latency, read by the reporter
+    std::mutex      statsLock;
+    TickJitterStats lateness;    // Tick start minus its deadline
+    TickJitterStats serviceTime; // step() + render + write
+    long long       droppedFrames = 0;
+    int             stage         = 0;
+    std::string     shownName;
+};
+
+static WorkStealingPool      pool;
+static SharedLeaderboard     sharedBoard;
+static std::atomic<bool>     persistWanted{false}; // A game finished since the last persist
+static volatile sig_atomic_t stopRequested = 0;
+static int                   boardHeight = DEFAULT_HEIGHT, boardWidth = DEFAULT_WIDTH;
+static std::random_device    rd;
+static std::mutex            seedLock; // random_device isn't safe to share between workers
+
+// Snapshots of the games players quit, by name, until they come back
+static std::mutex                                                 savedLock;
+static std::unordered_map<std::string, std::vector<std::uint8_t>> savedGames;
+static size_t                                                     savedBytes = 0;
+
+static void onSignal(int) { stopRequested = 1; }
+
+// --- Worker side ---
+
+// Sends what the client will take; the rest waits for the next run. A client that falls
+// too far behind loses the backlog and gets a full redraw instead.
+static void flushOutput(Session &s) {
+    s.pending += s.screen.out;
+    s.screen.reset();
+    size_t sent = 0;
+    while (sent < s.pending.size()) {
+        ssize_t n = write(s.fd, s.pending.data() + sent, s.pending.size() - sent);
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+                s.closing.store(true, std::memory_order_release);
+            break;
+        }
+        sent += n;
+    }
+    s.pending.erase(0, sent);
+    if (s.pending.size() > MAX_PENDING_OUTPUT) {
+        s.pending.clear();
+        s.fullRedraw = true;
+        std::lock_guard<std::mutex> guard(s.statsLock);
+        s.droppedFrames++;
+    }
+}
+
+static void drawNamePrompt(Session &s) {
+    s.screen.clearScreen();
+    s.screen.line(2, 4, "Welcome to 🐍 Snake Game! 🐍");
+    s.screen.line(4, 4, "Enter your name: %s", s.name.c_str());
+    s.screen.out += "\x1b[?25h"; // Show the cursor while typing
+}
+
+static void saveGame(Session &s) {
+    if (s.name.empty())
+        return; // Nobody to give it back to
+    std::vector<std::uint8_t> snapshot;
+    encodeSnapshot(s.game, snapshot);
+    std::lock_guard<std::mutex> guard(savedLock);
+    auto                        saved = savedGames.find(s.name);
+    size_t                      freed = saved == savedGames.end() ? 0 : saved->second.size();
+    if (savedBytes - freed + snapshot.size() > MAX_SAVED_BYTES)
+        return; // Full; an older save under this name stays
+    savedBytes += snapshot.size() - freed;
+    savedGames[s.name].swap(snapshot);
+}
+
+// Takes the game this name quit out of savedGames into s.game.
+static bool resumeSavedGame(Session &s) {
+    std::vector<std::uint8_t> snapshot;
+    {
+        std::lock_guard<std::mutex> guard(savedLock);
+        auto                        saved = savedGames.find(s.name);
+        if (saved == savedGames.end())
+            return false;
+        snapshot.swap(saved->second);
+        savedGames.erase(saved);
+        savedBytes -= snapshot.size();
+    }
+    return decodeSnapshot(s.game, snapshot.data(), snapshot.size()) && !s.game.gameOver;
+}
+
+static void beginPlaying(Session &s) {
+    s.phase      = PHASE_PLAYING;
+    s.paused     = false;
+    s.fullRedraw = true;
+    s.turns.clear();
+    s.clock = TickScheduler();
+    s.clock.start(delay_per_stage[s.game.currentStage]);
+    s.screen.out += "\x1b[?25l";
+}
+
+static void startGame(Session &s) {
+    s.checkpoint.clear();
+    if (!resumeSavedGame(s)) {
+        unsigned seed;
+        {
+            std::lock_guard<std::mutex> guard(seedLock);
+            seed = rd();
+        }
+        initGame(s.game, seed, boardHeight, boardWidth);
+    }
+    beginPlaying(s);
+}
+
+static void drawGame(Session &s) {
+    if (s.fullRedraw)
+        s.screen.clearScreen();
+    s.screen.drawBoard(s.game, s.fullRedraw);
+    s.screen.drawHud(s.game, sharedBoard.highScore());
+    if (s.paused)
+        s.screen.line(s.game.height / 2, 2, "PAUSED - Press 'P' to resume");
+    s.fullRedraw = false;
+}
+
+static void drawGameOver(Session &s) {
+    int score = finalScore(s.game);
+    s.screen.clearScreen();
+    s.screen.line(3, 4, "%s", s.game.gameWon ? "🎉 CONGRATULATIONS! ALL STAGES CLEARED! 🎉"
+                                             : " G A M E   O V E R ");
+    s.screen.line(5, 4, "Final Score for %s: %d", s.name.c_str(), score);
+    if (s.rank > 0)
+        s.screen.line(6, 4, "Your Ranking: %lld / %lld", s.rank, sharedBoard.storedEntries());
+    else
+        s.screen.line(6, 4, "Your Ranking: ...");
+    if (!s.game.gameWon && !s.checkpoint.empty())
+        s.screen.line(8, 4, "Press [spacebar] to play again, [c] to retry stage %d, [q] to leave.",
+                      s.game.currentStage + 1);
+    else
+        s.screen.line(8, 4, "Press [spacebar] to play again, [q] to leave.");
+}
+
+static void finishGame(Session &s) {
+    s.sequence = sharedBoard.insert(s.name.empty() ? "Player" : s.name, finalScore(s.game));
+    s.rank     = -1;
+    s.phase    = PHASE_OVER;
+    persistWanted.store(true, std::memory_order_release);
+    drawGameOver(s);
+}
+
+static void handleKey(Session &s, const KeyEvent &event) {
+    int key = event.key;
+    switch (s.phase) {
+    case PHASE_NAME:
+        if (key == '\r' || key == '\n') {
+            startGame(s);
+        } else if ((key == 127 || key == 8) && !s.name.empty()) {
+            s.name.pop_back();
+            drawNamePrompt(s);
+        } else if (key >= 0x20 && key < 0x100 && key != 127 &&
+                   (int)s.name.size() < MAX_NAME_LENGTH) {
+            s.name += (char)key;
+            drawNamePrompt(s);
+        }
+        break;
+    case PHASE_PLAYING:
+        if (key == 'q' || key == 'Q') {
+            // Quit: nothing is recorded, the game is kept for the name. A pty stays up for the
+            // next player.
+            saveGame(s);
+            s.game.gameOverReason = 7;
+            s.phase               = PHASE_NAME;
+            s.closing.store(!s.isPty, std::memory_order_release);
+            s.name.clear();
+            drawNamePrompt(s);
+        } else if (key == 'p' || key == 'P') {
+            s.paused     = !s.paused;
+            s.fullRedraw = true;
+            s.turns.clear();
+            if (!s.paused)
+                s.clock.resync();
+            drawGame(s);
+        } else if (!s.paused) {
+            int dir = keyToDirection(key);
+            if (dir != NO_INPUT)
+                s.turns.push(dir, event.timeNs, s.game.dirIndex);
+        }
+        break;
+    case PHASE_BANNER:
+        break; // Keys pressed during the banner are dropped
+    case PHASE_OVER:
+        if (key == ' ') {
+            startGame(s);
+        } else if ((key == 'c' || key == 'C') && !s.game.gameWon && !s.checkpoint.empty() &&
+                   decodeSnapshot(s.game, s.checkpoint.data(), s.checkpoint.size())) {
+            beginPlaying(s);
+        } else if (key == 'q' || key == 'Q') {
+            s.closing.store(!s.isPty, std::memory_order_release);
+            s.phase = PHASE_NAME;
+            s.name.clear();
+            drawNamePrompt(s);
+        }
+        break;
+    }
+}
+
+// One tick: the same order as playGame() in snake_game.
+static void tick(Session &s) {
+    long long deadline = s.clock.deadlineNs;
+    s.clock.beginTick();
+    long long start = monotonicNs();
+
+    int        turn   = s.turns.pop(start);
+    StepResult result = step(s.game, turn);
+    if (result == STEP_STAGE_CLEAR) {
+        encodeSnapshot(s.game, s.checkpoint);
+        s.phase       = PHASE_BANNER;
+        s.bannerEndNs = start + STAGE_BANNER_NS;
+        s.screen.clearScreen();
+        s.screen.line(s.game.height / 2, 4, "🎉 STAGE %d CLEARED! NEXT STAGE! 🎉",
+                      s.game.currentStage);
+    } else if (result == STEP_GAME_OVER || result == STEP_GAME_WON) {
+        finishGame(s);
+    } else {
+        drawGame(s);
+    }
+    flushOutput(s);
+
+    std::lock_guard<std::mutex> guard(s.statsLock);
+    s.lateness.record(start - deadline);
+    s.serviceTime.record(monotonicNs() - start);
+    s.stage = s.game.currentStage;
+}
+
+static void runSession(void *arg) {
+    Session &s = *(Session *)arg;
+
+    KeyEvent event;
+    while (s.keys.pop(event))
+        handleKey(s, event);
+
+    long long now  = monotonicNs();
+    long long wake = IDLE_WAKE_NS;
+    switch (s.phase) {
+    case PHASE_PLAYING:
+        if (!s.paused && now >= s.clock.deadlineNs)
+            tick(s);
+        if (s.phase == PHASE_PLAYING)
+            wake = s.paused ? IDLE_WAKE_NS : s.clock.deadlineNs;
+        else if (s.phase == PHASE_BANNER)
+            wake = s.bannerEndNs;
+        else
+            wake = now + RANK_POLL_NS;
+        break;
+    case PHASE_BANNER:
+        if (now >= s.bannerEndNs) {
+            s.phase       = PHASE_PLAYING;
+            s.fullRedraw  = true;
+            s.turns.clear();
+            s.clock = TickScheduler();
+            s.clock.start(delay_per_stage[s.game.currentStage]);
+            drawGame(s);
+            wake = s.clock.deadlineNs;
+        } else {
+            wake = s.bannerEndNs;
+        }
+        break;
+    case PHASE_OVER:
+        if (s.rank < 0) {
+            s.rank = sharedBoard.rankOf(s.sequence, 0);
+            if (s.rank > 0)
+                drawGameOver(s);
+            else
+                wake = now + RANK_POLL_NS;
+        }
+        break;
+    case PHASE_NAME:
+        break;
+    }
+    if (s.phase == PHASE_NAME && s.fullRedraw) {
+        drawNamePrompt(s);
+        s.fullRedraw = false;
+    }
+    if (!s.screen.out.empty() || !s.pending.empty())
+        flushOutput(s);
+
+    {
+        std::lock_guard<std::mutex> guard(s.statsLock);
+        s.shownName = s.name;
+    }
+    s.wakeNs.store(wake, std::memory_order_relaxed);
+    s.scheduled.store(false, std::memory_order_release);
+}
+
+// --- Main thread ---
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+static std::vector<std::unique_ptr<Session>> sessions;
+static int                                   nextSessionId = 1;
+
+static Session *addSession(int fd) {
+    setNonBlocking(fd);
+    auto session = std::make_unique<Session>();
+    session->id  = nextSessionId++;
+    session->fd  = fd;
+    session->screen.enterScreen();
+    sessions.push_back(std::move(session));
+    return sessions.back().get();
+}
+
+// A pseudo-terminal in raw mode; players attach to the slave side.
+static Session *openPtySession() {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        if (master >= 0)
+            close(master);
+        return nullptr;
+    }
+    const char *slavePath = ptsname(master);
+    int         slave     = slavePath ? open(slavePath, O_RDWR | O_NOCTTY) : -1;
+    termios     tio;
+    if (slave < 0 || tcgetattr(slave, &tio) != 0) {
+        close(master);
+        if (slave >= 0)
+            close(slave);
+        return nullptr;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    Session *session    = addSession(master);
+    session->isPty      = true;
+    session->ptySlaveFd = slave;
+    printf("session %d: %s\n", session->id, slavePath);
+    return session;
+}
+
+static int listenOn(const char *path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+        return -1;
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    unlink(path); // Left over from a server that didn't shut down cleanly
+    if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+static void schedule(Session &s) {
+    if (s.scheduled.exchange(true, std::memory_order_acq_rel))
+        return; // Already queued; it will see the new keys
+    pool.submit({runSession, &s});
+}
+
+static void closeSession(Session &s) {
+    AnsiRenderer goodbye;
+    goodbye.leaveScreen();
+    if (write(s.fd, goodbye.out.data(), goodbye.out.size()) < 0) {
+        // The client is already gone
+    }
+    close(s.fd);
+    if (s.ptySlaveFd >= 0)
+        close(s.ptySlaveFd);
+}
+
+// Per-session tick latency since the last report, to stderr.
+static void report() {
+    if (sessions.empty())
+        return;
+    TickJitterStats allLate, allService;
+    long long       dropped = 0;
+    fprintf(stderr, "%-8s %-16s %5s %8s %10s %10s %10s %10s %7s\n", "session", "name", "stage",
+            "ticks", "late avg", "late max", "svc avg", "svc max", "dropped");
+    for (auto &session : sessions) {
+        Session                    &s = *session;
+        std::lock_guard<std::mutex> guard(s.statsLock);
+        if (s.lateness.ticks > 0)
+            fprintf(stderr, "%-8d %-16.16s %5d %8lld %8.1fus %8.1fus %8.1fus %8.1fus %7lld\n",
+                    s.id, s.shownName.c_str(), s.stage + 1, s.lateness.ticks, s.lateness.meanUs(),
+                    s.lateness.maxUs(), s.serviceTime.meanUs(), s.serviceTime.maxUs(),
+                    s.droppedFrames);
+        allLate.merge(s.lateness);
+        allService.merge(s.serviceTime);
+        dropped += s.droppedFrames;
+        s.lateness      = TickJitterStats();
+        s.serviceTime   = TickJitterStats();
+        s.droppedFrames = 0;
+    }
+    fprintf(stderr,
+            "all: %zu sessions, %lld ticks, late avg %.1f us max %.1f us (%lld >= 1 ms), "
+            "service avg %.1f us max %.1f us, %lld dropped, %lld steals\n",
+            sessions.size(), allLate.ticks, allLate.meanUs(), allLate.maxUs(), allLate.lateTicks,
+            allService.meanUs(), allService.maxUs(), dropped, pool.steals());
+}
+
+int main(int argc, char **argv) {
+    const char *socketPath = DEFAULT_SOCKET_PATH;
+    int         ptyCount   = 0;
+    int         threads    = (int)std::thread::hardware_concurrency();
+    int         reportSec  = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--ptys") == 0 && i + 1 < argc) {
+            ptyCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportSec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc &&
+                   parseBoardSize(argv[i + 1], boardHeight, boardWidth)) {
+            ++i;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--socket PATH] [--ptys N] [--threads N] [--board HxW] "
+                    "[--report SEC]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (!sharedBoard.attach()) {
+        fprintf(stderr, "cannot map the shared leaderboard %s\n", SHARED_LEADERBOARD_FILE);
+        return 1;
+    }
+    int listenFd = listenOn(socketPath);
+    if (listenFd < 0) {
+        fprintf(stderr, "cannot listen on %s: %s\n", socketPath, strerror(errno));
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    pool.start(threads);
+    printf("listening on %s with %d threads\n", socketPath, pool.size());
+    for (int i = 0; i < ptyCount && sessions.size() < MAX_SESSIONS; ++i)
+        if (Session *session = openPtySession())
+            schedule(*session);
+    fflush(stdout);
+
+    std::vector<pollfd>    fds;
+    std::vector<Session *> polled;
+    long long              nextReportNs = monotonicNs() + reportSec * 1000000000LL;
+    while (!stopRequested) {
+        // Sleep until input arrives or the earliest session is due
+        long long now    = monotonicNs();
+        long long wakeNs = now + MAIN_POLL_NS;
+        fds.assign(1, {listenFd, POLLIN, 0});
+        polled.clear();
+        for (auto &session : sessions) {
+            if (session->closing.load(std::memory_order_acquire))
+                continue;
+            fds.push_back({session->fd, POLLIN, 0});
+            polled.push_back(session.get());
+            if (!session->scheduled.load(std::memory_order_acquire))
+                wakeNs = std::min(wakeNs, session->wakeNs.load(std::memory_order_relaxed));
+        }
+        // ppoll: poll()'s millisecond timeout would start every tick up to 1 ms late
+        long long waitNs = std::max(0LL, wakeNs - now);
+        timespec  timeout;
+        timeout.tv_sec  = waitNs / 1000000000LL;
+        timeout.tv_nsec = waitNs % 1000000000LL;
+        if (ppoll(fds.data(), fds.size(), &timeout, nullptr) < 0 && errno != EINTR)
+            break;
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                if (sessions.size() >= MAX_SESSIONS) {
+                    close(fd);
+                    continue;
+                }
+                schedule(*addSession(fd));
+            }
+        }
+
+        // Keys go to the session's ring; the worker applies them on its next run
+        unsigned char buf[256];
+        now = monotonicNs();
+        for (size_t i = 1; i < fds.size(); ++i) {
+            Session &s = *polled[i - 1];
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            ssize_t n = read(s.fd, buf, sizeof(buf));
+            if (n <= 0) {
+                if (n == 0 || (errno != EAGAIN && errno != EINTR))
+                    s.closing.store(true, std::memory_order_release);
+                continue;
+            }
+            for (ssize_t j = 0; j < n; ++j) {
+                int key = s.decoder.feed(buf[j]);
+                if (key >= 0)
+                    s.keys.push({key, now});
+            }
+            schedule(s);
+        }
+
+        now = monotonicNs();
+        for (auto &session : sessions)
+            if (!session->closing.load(std::memory_order_acquire) &&
+                session->wakeNs.load(std::memory_order_relaxed) <= now)
+                schedule(*session);
+
+        // Disconnected sessions go once no worker holds them
+        for (size_t i = 0; i < sessions.size();) {
+            Session &s = *sessions[i];
+            if (s.closing.load(std::memory_order_acquire) &&
+                !s.scheduled.load(std::memory_order_acquire)) {
+                closeSession(s);
+                sessions.erase(sessions.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+
+        if (persistWanted.exchange(false, std::memory_order_acq_rel))
+            sharedBoard.persistAsync();
+        if (reportSec > 0 && now >= nextReportNs) {
+            report();
+            nextReportNs = now + reportSec * 1000000000LL;
+        }
+    }
+
+    pool.stop();
+    report();
+    for (auto &session : sessions)
+        closeSession(*session);
+    sessions.clear();
+    close(listenFd);
+    unlink(socketPath);
+    sharedBoard.waitForPersist();
+    sharedBoard.persistNow();
+    return 0;
+}
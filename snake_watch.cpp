@@ -0,0 +1,222 @@
+// snake_watch.cpp - 다른 터미널에서 진행 중인 snake_game 을 구경하는 뷰어
+// snake_game --broadcast 가 연 소켓에 붙어 KEYFRAME 과 DELTA 를 받고 ANSI 렌더러로 그린다.
+// 읽어 온 메시지를 모두 적용한 뒤 한 번만 그리므로, 뷰어가 느려도 변화가 한 프레임으로 합쳐질
+// 뿐 밀리지 않는다. 게임이 끝나면 다음 게임의 KEYFRAME 을 기다린다.
+//
+// Run: ./snake_watch [SOCKET]   (default snake_watch.sock, 'q' quits)
+
+#include "ansi_renderer.h"
+#include "broadcast.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define READ_CHUNK (64 * 1024)
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) { stopRequested = 1; }
+
+static int connectTo(const char *path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+static const char *endReasonText(int reason) {
+    switch (reason) {
+    case 1:
+        return "U-turn attempted";
+    case 2:
+        return "Collided with a wall";
+    case 3:
+        return "Collided with self";
+    case 4:
+        return "Stage turn limit exceeded";
+    case 5:
+        return "Snake length too short (<3)";
+    case 6:
+        return "Entered gate during cooldown";
+    case 7:
+        return "The player quit";
+    default:
+        return "Unknown mishap";
+    }
+}
+
+// Same panel as AnsiRenderer::drawHud(), from the counters the game sent.
+static void drawWatchHud(AnsiRenderer &screen, const WatchView &view) {
+    const int       *c     = view.counters;
+    const GameRules &rules = defaultRules;
+    int              x     = view.board.width * 3 + 5;
+    int              y     = 1;
+    int              stage = c[WATCH_STAGE] < STAGES ? c[WATCH_STAGE] : STAGES - 1;
+    auto             done  = [](bool reached) { return reached ? "✅" : "  "; };
+
+    screen.line(y++, x, "👀 Watching %s", view.name.c_str());
+    screen.line(y++, x, "----- SCOREBOARD -----");
+    screen.line(y++, x, "🍎 Growth Items: %d pts", c[WATCH_GROWTH_POINTS]);
+    screen.line(y++, x, "☠️  Poison Items: %d pts", c[WATCH_POISON_POINTS]);
+    screen.line(y++, x, "🚪 Gates Used  : %d pts", c[WATCH_GATE_POINTS]);
+    screen.line(y++, x, "----------------------");
+    screen.line(y++, x, "🏆 Current Score: %d", c[WATCH_SCORE]);
+    screen.line(y++, x, "⭐ High Score   : %d", c[WATCH_HIGH_SCORE]);
+    screen.line(y++, x, "----------------------");
+    if (c[WATCH_ITEM_TICKS] > 0)
+        screen.line(y++, x, "⏳ Items Despawn: %d ticks", c[WATCH_ITEM_TICKS]);
+    else
+        screen.line(y++, x, "⏳ Items Despawn: N/A");
+    if (c[WATCH_GATE_TICKS] > 0)
+        screen.line(y++, x, "⏳ Gates Despawn: %d ticks", c[WATCH_GATE_TICKS]);
+    else
+        screen.line(y++, x, "⏳ Gates Despawn: N/A");
+    y++; // Gap before the mission panel
+
+    int length = c[WATCH_LENGTH];
+    screen.line(y++, x, "-------- MISSION (Stage %d) --------", stage + 1);
+    screen.line(y++, x, "🐍 Length: %d/%d (%s) (Max: %d)", length,
+                rules.mission_length_per_stage[stage],
+                done(length >= rules.mission_length_per_stage[stage]), c[WATCH_MAX_LENGTH]);
+    screen.line(y++, x, "🍎 Growth: %d/%d (%s)", c[WATCH_GROWTH_ITEMS],
+                rules.mission_growth_per_stage[stage],
+                done(c[WATCH_GROWTH_ITEMS] >= rules.mission_growth_per_stage[stage]));
+    screen.line(y++, x, "☠️  Poison: %d/%d (%s)", c[WATCH_POISON_ITEMS],
+                rules.mission_poison_per_stage[stage],
+                done(c[WATCH_POISON_ITEMS] >= rules.mission_poison_per_stage[stage]));
+    screen.line(y++, x, "🚪 Gates : %d/%d (%s)", c[WATCH_GATES_USED],
+                rules.mission_gate_per_stage[stage],
+                done(c[WATCH_GATES_USED] >= rules.mission_gate_per_stage[stage]));
+    screen.line(y++, x, "----------------------------------");
+    screen.line(y++, x, "⏱️  Turns Left: %d",
+                rules.stageTurnLimitPerStage[stage] - c[WATCH_TURNS_USED]);
+    screen.line(y++, x, "----------------------------------");
+
+    // Status under the board
+    int status = view.board.height + 1;
+    if (!view.ended)
+        screen.line(status, 0, "tick %lld  ('q' stops watching)", view.tick);
+    else if (view.won)
+        screen.line(status, 0,
+                    "\x1b[1;32m🎉 ALL STAGES CLEARED! 🎉\x1b[0m Final score %d. Waiting for "
+                    "the next game...",
+                    view.finalScore);
+    else
+        screen.line(status, 0,
+                    "\x1b[1;31mGAME OVER\x1b[0m %s. Final score %d. Waiting for the next "
+                    "game...",
+                    endReasonText(view.endReason), view.finalScore);
+}
+
+int main(int argc, char **argv) {
+    const char *path = DEFAULT_WATCH_SOCKET;
+    if (argc == 2 && argv[1][0] != '-') {
+        path = argv[1];
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: %s [SOCKET]  (default %s)\n", argv[0], DEFAULT_WATCH_SOCKET);
+        return 1;
+    }
+    int fd = connectTo(path);
+    if (fd < 0) {
+        fprintf(stderr, "snake_watch: can't connect to %s: %s (is snake_game --broadcast on?)\n",
+                path, strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    // Keys without Enter or echo, so 'q' works
+    termios saved, raw;
+    bool    tty = tcgetattr(STDIN_FILENO, &saved) == 0;
+    if (tty) {
+        raw = saved;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+
+    AnsiRenderer screen;
+    screen.enterScreen();
+    screen.line(0, 0, "Waiting for a game on %s...", path);
+    screen.writeFrame(STDOUT_FILENO);
+
+    WatchView                 view;
+    std::vector<std::uint8_t> buffer;
+    const char               *closed = nullptr; // Why the stream ended
+    while (!stopRequested && !closed) {
+        pollfd fds[2] = {{fd, POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0)
+            continue; // EINTR from a signal
+        if (fds[1].revents & POLLIN) {
+            char key;
+            if (read(STDIN_FILENO, &key, 1) == 1 && (key == 'q' || key == 'Q'))
+                break;
+        }
+        if (!(fds[0].revents & (POLLIN | POLLHUP)))
+            continue;
+
+        size_t  kept = buffer.size();
+        buffer.resize(kept + READ_CHUNK);
+        ssize_t n = read(fd, buffer.data() + kept, READ_CHUNK);
+        buffer.resize(kept + (n > 0 ? n : 0));
+        if (n == 0)
+            closed = "the game has closed the stream";
+        else if (n < 0 && errno != EINTR && errno != EAGAIN)
+            closed = strerror(errno);
+
+        // Everything that arrived is applied, then drawn once
+        bool   full = false, changed = false;
+        size_t pos = 0, used;
+        while (true) {
+            int type = readWatchMessage(view, buffer.data() + pos, buffer.size() - pos, used);
+            pos += used;
+            if (type == 0)
+                break;
+            if (type < 0) {
+                closed = "not a snake_game spectator stream";
+                break;
+            }
+            full |= type == WATCH_KEYFRAME;
+            changed = true;
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + pos);
+
+        if (changed && view.ready) {
+            if (full)
+                screen.clearScreen();
+            screen.drawBoard(view.board, full);
+            drawWatchHud(screen, view);
+            screen.writeFrame(STDOUT_FILENO);
+        }
+    }
+
+    screen.leaveScreen();
+    screen.writeFrame(STDOUT_FILENO);
+    if (tty)
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    close(fd);
+    if (closed)
+        fprintf(stderr, "snake_watch: %s\n", closed);
+    return closed && !view.ready ? 1 : 0;
+}
@@ -0,0 +1,414 @@
+// snapshot.cpp - 스냅샷 인코딩/디코딩과 파일 입출력
+
+#include "snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+static const int dy[4] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
+static const int dx[4] = {0, 0, -1, 1};
+
+// --- Encoding helpers ---
+
+static void putByte(std::vector<std::uint8_t> &out, unsigned value) {
+    out.push_back((std::uint8_t)value);
+}
+
+static void putU16(std::vector<std::uint8_t> &out, unsigned value) {
+    putByte(out, value & 0xff);
+    putByte(out, (value >> 8) & 0xff);
+}
+
+static void putU64(std::vector<std::uint8_t> &out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i)
+        putByte(out, (value >> (i * 8)) & 0xff);
+}
+
+static void putVarint(std::vector<std::uint8_t> &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        putByte(out, (value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    putByte(out, (unsigned)value);
+}
+
+// Zigzag: small negative numbers stay short too
+static void putSigned(std::vector<std::uint8_t> &out, long long value) {
+    putVarint(out, ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63));
+}
+
+struct SnapshotReader {
+    const std::uint8_t *data;
+    size_t              size;
+    size_t              pos = 0;
+    bool                ok  = true;
+
+    unsigned byte() {
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+    unsigned u16() {
+        unsigned low = byte();
+        return low | (byte() << 8);
+    }
+    std::uint64_t u64() {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= (std::uint64_t)byte() << (i * 8);
+        return value;
+    }
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned b = byte();
+            value |= (std::uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+    long long svarint() {
+        std::uint64_t value = varint();
+        return (long long)(value >> 1) ^ -(long long)(value & 1);
+    }
+    // A varint below `limit`; fails the read otherwise
+    int below(std::uint64_t limit) {
+        std::uint64_t value = varint();
+        if (value >= limit)
+            ok = false;
+        return ok ? (int)value : 0;
+    }
+};
+
+using Wheel = TimingWheel<MAX_TIMERS>;
+
+static bool isItem(int value) { return value == CELL_GROWTH || value == CELL_POISON; }
+
+// The cell as the layout has it: snake and item cells are floor, gates are walls
+static int terrainAt(const GameState &state, int cell) {
+    int value = state.map[cell];
+    if (value == CELL_SNAKE || isItem(value))
+        return CELL_EMPTY;
+    return value == CELL_GATE ? CELL_WALL : value;
+}
+
+// Direction from `from` to the adjacent cell `to`, or -1 when they aren't neighbours
+static int stepDirection(const GameState &state, int from, int to) {
+    const int W = state.width;
+    int       y = from / W, x = from % W;
+    for (int d = 0; d < 4; ++d) {
+        int ny = y + dy[d], nx = x + dx[d];
+        if (ny >= 0 && ny < state.height && nx >= 0 && nx < W && ny * W + nx == to)
+            return d;
+    }
+    return -1;
+}
+
+void encodeSnapshot(const GameState &state, std::vector<std::uint8_t> &out) {
+    const int area  = state.height * state.width;
+    const int count = state.snake.size();
+    out.assign(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+    putByte(out, SNAPSHOT_VERSION);
+    putU16(out, state.height);
+    putU16(out, state.width);
+    putByte(out, state.currentStage);
+    putByte(out,
+            (state.gameOver ? 1 : 0) | (state.gameWon ? 2 : 0) | (state.autopilotUsed ? 4 : 0));
+    putByte(out, state.gameOverReason);
+    putByte(out, state.dirIndex | (state.prevDirIndex << 2));
+    putU64(out, state.rng.state);
+    putU64(out, state.rng.inc);
+
+    putVarint(out, state.collected_growth_items);
+    putVarint(out, state.collected_poison_items);
+    putVarint(out, state.gates_used_count);
+    putVarint(out, state.stageTurnCounter);
+    putSigned(out, state.total_score_growth);
+    putSigned(out, state.total_score_poison);
+    putSigned(out, state.total_score_gate);
+    putVarint(out, state.maxLengthAchieved);
+
+    // Layout runs
+    for (int cell = 0; cell < area;) {
+        int value = terrainAt(state, cell);
+        int run   = 1;
+        while (cell + run < area && terrainAt(state, cell + run) == value)
+            ++run;
+        putByte(out, value);
+        putVarint(out, run);
+        cell += run;
+    }
+
+    // Snake: the segments that didn't come through a gate are one step from the previous one
+    putVarint(out, count);
+    if (count > 0)
+        putVarint(out, state.snake.front());
+    int jumps = 0;
+    for (int i = 1; i < count; ++i)
+        jumps += stepDirection(state, state.snake.at(i - 1), state.snake.at(i)) < 0;
+    putVarint(out, jumps);
+    for (int i = 1, last = 0; i < count && jumps > 0; ++i) {
+        if (stepDirection(state, state.snake.at(i - 1), state.snake.at(i)) >= 0)
+            continue;
+        putVarint(out, i - last);
+        putVarint(out, state.snake.at(i));
+        last = i;
+        jumps--;
+    }
+    unsigned packed = 0;
+    for (int i = 1; i < count; ++i) {
+        int d = stepDirection(state, state.snake.at(i - 1), state.snake.at(i));
+        packed |= (d < 0 ? 0 : d) << (((i - 1) & 3) * 2);
+        if ((i & 3) == 0 || i == count - 1) {
+            putByte(out, packed);
+            packed = 0;
+        }
+    }
+
+    const int W = state.width;
+    putVarint(out, state.gateA.first < 0 ? 0 : state.gateA.first * W + state.gateA.second + 1);
+    putVarint(out, state.gateB.first < 0 ? 0 : state.gateB.first * W + state.gateB.second + 1);
+
+    putByte(out, state.itemCount);
+    for (int i = 0; i < state.itemCount; ++i) {
+        const GameState::LiveItem &item = state.items[i];
+        putByte(out, state.map[item.cell]);
+        putVarint(out, item.cell);
+        putVarint(out, item.timer);
+    }
+
+    // The wheel as it is, list by list, so a restored game fires same-tick timers in the same
+    // order and hands out the same ids
+    const Wheel &timers = state.timers;
+    putVarint(out, timers.active(state.gateTimer) ? state.gateTimer + 1 : 0);
+    putVarint(out, timers.active(state.gateCooldownTimer) ? state.gateCooldownTimer + 1 : 0);
+    putVarint(out, timers.base);
+    int active = 0;
+    for (int id = 0; id < MAX_TIMERS; ++id)
+        active += timers.active(id);
+    putVarint(out, active);
+    for (int list = 0; list < Wheel::WORK_LIST; ++list) {
+        for (int id = timers.heads[list]; id >= 0; id = timers.nodes[id].next) {
+            putVarint(out, list);
+            putVarint(out, id);
+            putVarint(out, timers.nodes[id].expires - timers.base);
+            putByte(out, timers.nodes[id].kind);
+            putVarint(out, timers.nodes[id].payload);
+        }
+    }
+    for (int id = timers.heads[Wheel::FREE_LIST]; id >= 0; id = timers.nodes[id].next)
+        putVarint(out, id);
+}
+
+bool decodeSnapshot(GameState &state, const std::uint8_t *data, size_t size,
+                    const GameRules &rules) {
+    if (size < 5 || memcmp(data, SNAPSHOT_MAGIC, 4) != 0 || data[4] != SNAPSHOT_VERSION)
+        return false;
+    SnapshotReader in{data, size, 5};
+    int            height = in.u16();
+    int            width  = in.u16();
+    if (!in.ok || height < MIN_BOARD_SIZE || height > MAX_BOARD_SIZE || width < MIN_BOARD_SIZE ||
+        width > MAX_BOARD_SIZE)
+        return false;
+    resetBoard(state, height, width, rules);
+    const int area = height * width;
+
+    state.currentStage           = in.byte();
+    unsigned flags               = in.byte();
+    state.gameOver               = (flags & 1) != 0;
+    state.gameWon                = (flags & 2) != 0;
+    state.autopilotUsed          = (flags & 4) != 0;
+    state.gameOverReason         = in.byte();
+    unsigned directions          = in.byte();
+    state.dirIndex               = directions & 3;
+    state.prevDirIndex           = (directions >> 2) & 3;
+    state.rng.state              = in.u64();
+    state.rng.inc                = in.u64() | 1;
+    state.collected_growth_items = (int)in.varint();
+    state.collected_poison_items = (int)in.varint();
+    state.gates_used_count       = (int)in.varint();
+    state.stageTurnCounter       = (int)in.varint();
+    state.total_score_growth     = (int)in.svarint();
+    state.total_score_poison     = (int)in.svarint();
+    state.total_score_gate       = (int)in.svarint();
+    state.maxLengthAchieved      = (int)in.varint();
+    if ((state.currentStage >= STAGES && !state.gameWon) || flags > 7)
+        return false;
+
+    for (int cell = 0; cell < area && in.ok;) {
+        int value = in.byte();
+        int run   = in.below(area - cell + 1);
+        if (run == 0 || (value != CELL_EMPTY && value != CELL_WALL && value != CELL_IMMUNE_WALL))
+            return false;
+        memset(state.map.data() + cell, value, run);
+        cell += run;
+    }
+
+    // Snake segments go on floor cells, each once
+    int count = in.below(area + 1);
+    if (!in.ok || (count < 3 && !state.gameOver))
+        return false;
+    int              cell  = count > 0 ? in.below(area) : 0;
+    int              jumps = in.below(count > 0 ? count : 1);
+    std::vector<int> jumpAt, jumpCell;
+    for (int i = 0, index = 0; i < jumps && in.ok; ++i) {
+        int gap = in.below(count);
+        index += gap;
+        if (gap == 0 || index >= count)
+            return false;
+        jumpAt.push_back(index);
+        jumpCell.push_back(in.below(area));
+    }
+    size_t moveBytes = count > 1 ? (size_t)(count - 1 + 3) / 4 : 0;
+    if (!in.ok || in.size - in.pos < moveBytes)
+        return false;
+    const std::uint8_t *moves = in.data + in.pos;
+    in.pos += moveBytes;
+    for (int i = 0, jump = 0; i < count; ++i) {
+        if (i > 0 && jump < jumps && jumpAt[jump] == i) {
+            cell = jumpCell[jump++];
+        } else if (i > 0) {
+            int d  = (moves[(i - 1) / 4] >> (((i - 1) & 3) * 2)) & 3;
+            int ny = cell / width + dy[d], nx = cell % width + dx[d];
+            if (ny < 0 || ny >= height || nx < 0 || nx >= width)
+                return false;
+            cell = ny * width + nx;
+        }
+        if (state.map[cell] != CELL_EMPTY)
+            return false;
+        state.map[cell] = CELL_SNAKE;
+        state.snake.pushBack((CellIndex)cell);
+    }
+    if (count > 0) {
+        state.headY = state.snake.front() / width;
+        state.headX = state.snake.front() % width;
+    }
+
+    // Gates open on walls, items sit on floor
+    std::pair<int, int> *gates[2] = {&state.gateA, &state.gateB};
+    for (int g = 0; g < 2; ++g) {
+        int gate = in.below(area + 1) - 1;
+        if (gate < 0)
+            continue;
+        if (state.map[gate] != CELL_WALL)
+            return false;
+        state.map[gate]    = CELL_GATE;
+        state.gateExits[g] = GateExits{gate};
+        *gates[g]          = {gate / width, gate % width};
+    }
+
+    int itemCount = in.byte();
+    if (!in.ok || itemCount > MAX_LIVE_ITEMS)
+        return false;
+    for (int i = 0; i < itemCount; ++i) {
+        int type             = in.byte();
+        int itemCell         = in.below(area);
+        state.items[i].cell  = itemCell;
+        state.items[i].timer = in.below(MAX_TIMERS);
+        if (!in.ok || !isItem(type) || state.map[itemCell] != CELL_EMPTY)
+            return false;
+        state.map[itemCell] = type;
+    }
+    state.itemCount = itemCount;
+
+    // Every timer id once: the active ones list by list, then the free list in order
+    Wheel &timers           = state.timers;
+    state.gateTimer         = in.below(MAX_TIMERS + 1) - 1;
+    state.gateCooldownTimer = in.below(MAX_TIMERS + 1) - 1;
+
+    std::uint64_t base   = in.varint();
+    int           active = in.below(MAX_TIMERS + 1);
+    if (!in.ok || base >> 40)
+        return false;
+    timers.base           = (long long)base;
+    bool seen[MAX_TIMERS] = {};
+    for (int i = 0; i < MAX_TIMERS && in.ok; ++i) {
+        int list = i < active ? in.below(Wheel::WORK_LIST) : Wheel::FREE_LIST;
+        int id   = in.below(MAX_TIMERS);
+        if (!in.ok || seen[id])
+            return false;
+        seen[id] = true;
+        if (i < active) {
+            Wheel::Node &node = timers.nodes[id];
+            std::uint64_t due = in.varint();
+            node.expires      = timers.base + (long long)(due & ((1ULL << 40) - 1));
+            node.kind         = in.byte();
+            node.payload      = in.below(area);
+            if (!in.ok || due >> 40 || node.kind > TIMER_GATE_COOLDOWN ||
+                !timers.fits(list, node.expires))
+                return false;
+        }
+        timers.append(id, list);
+    }
+
+    // ...and each active one owned by exactly one item or gate field
+    bool owned[MAX_TIMERS] = {};
+    auto claim             = [&](int id, int kind, int payload) {
+        if (!timers.active(id) || owned[id] || timers.nodes[id].kind != kind ||
+            timers.nodes[id].payload != payload)
+            return false;
+        owned[id] = true;
+        return --active >= 0;
+    };
+    for (int i = 0; i < itemCount; ++i)
+        if (!claim(state.items[i].timer, TIMER_ITEM_EXPIRE, state.items[i].cell))
+            return false;
+    if ((state.gateTimer >= 0 && !claim(state.gateTimer, TIMER_GATE_RESPAWN, 0)) ||
+        (state.gateCooldownTimer >= 0 && !claim(state.gateCooldownTimer, TIMER_GATE_COOLDOWN, 0)) ||
+        active != 0)
+        return false;
+
+    // Spawns pick by rank, so indexes rebuilt from the board pick the same cells
+    rebuildCellIndex(state);
+    return in.ok && in.pos == in.size;
+}
+
+bool replaceFile(const char *path, const std::uint8_t *data, size_t size) {
+    std::string tmpPath = std::string(path) + ".tmp";
+    FILE       *file    = fopen(tmpPath.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = fwrite(data, 1, size, file) == size && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok      = fclose(file) == 0 && ok;
+    if (!ok || rename(tmpPath.c_str(), path) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    std::string dir   = path;
+    size_t      slash = dir.find_last_of('/');
+    dir               = slash == std::string::npos ? "." : dir.substr(0, slash + 1);
+    int dirFd         = open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
+bool saveSnapshot(const GameState &state, const char *path) {
+    std::vector<std::uint8_t> out;
+    encodeSnapshot(state, out);
+    return replaceFile(path, out.data(), out.size());
+}
+
+bool loadSnapshot(GameState &state, const char *path, const GameRules &rules) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return false;
+    std::vector<std::uint8_t> data;
+    std::uint8_t              chunk[4096];
+    size_t                    n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(file);
+    return decodeSnapshot(state, data.data(), data.size(), rules);
+}
@@ -0,0 +1,50 @@
+// snapshot.h - 진행 중인 게임의 저장/이어하기 스냅샷
+// 리플레이와 달리 처음부터 다시 돌리지 않고, 한 시점의 GameState 를 그대로 담는다.
+// 파일 구성 (정수는 모두 리틀 엔디언, svarint 는 zigzag 부호화한 varint):
+//   "SNKP" | version u8 | height u16 | width u16 | stage u8
+//   | flags u8 (gameOver, gameWon, autopilotUsed) | gameOverReason u8
+//   | dirIndex | prevDirIndex << 2 u8 | rng state u64 | rng inc u64
+//   | growth, poison, gates collected varint | stageTurnCounter varint
+//   | growth, poison, gate score svarint | maxLengthAchieved varint
+//   | 지형: (cell value u8 | run varint) ... 보드 끝까지. 뱀, 아이템 칸은 빈칸, 게이트는 벽으로 적는다
+//   | 뱀: length varint | head varint | jumpCount varint | jumpCount x (index varint | cell varint)
+//         | 나머지 마디마다 앞 마디에서의 방향 2비트 (4개씩 한 바이트, 게이트를 건넌 마디는 jump)
+//   | gateA + 1 varint | gateB + 1 varint (0: 없음)
+//   | itemCount u8 | itemCount x (type u8 | cell varint | timer id varint)
+//   | 타이머: gateTimer + 1, gateCooldownTimer + 1 varint (0: 없음) | 휠 base varint
+//         | activeCount varint | 휠 칸 순서대로 activeCount x (list varint | id varint
+//         | expires - base varint | kind u8 | payload varint) | 나머지 id 는 free list 순서대로 varint
+// 아이템/게이트는 빈 칸/게이트 후보를 칸 번호 순으로 세어 고르므로 두 인덱스는 보드에서 다시 만들고,
+// 타이머 휠 구조는 그대로 담으므로, 복원한 판은 같은 입력이면 원래 판과 똑같이 흘러간다.
+// 크기는 보드 넓이보다 지형 모양과 뱀 길이를 따른다: 21x21 보드면 200 바이트 안팎이다.
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "snake_engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define SNAPSHOT_MAGIC   "SNKP" // Not "SNKS", which the shared ranking segment uses
+#define SNAPSHOT_VERSION 3 // 2: index orders and the timer wheel, for exact restores,
+                           // 3: no index orders, spawns pick by rank
+#define SAVE_FILE        "saved_game.snks" // Written when the player quits with 'q'
+#define CHECKPOINT_FILE  "checkpoint.snks" // Start of the stage last reached
+
+// Replaces `out` with the encoded state. Reusing `out` avoids allocating.
+void encodeSnapshot(const GameState &state, std::vector<std::uint8_t> &out);
+// Restores a state encoded by encodeSnapshot() under `rules`, which must outlive the game.
+// False (and `state` unusable until the next initGame()) when the data is not valid.
+bool decodeSnapshot(GameState &state, const std::uint8_t *data, size_t size,
+                    const GameRules &rules = defaultRules);
+
+// Writes `data` to `path` through a synced temp file (`path`.tmp) renamed over it, so a crash
+// or a full disk midway leaves the previous file as it was. saveReplay() writes this way too.
+bool replaceFile(const char *path, const std::uint8_t *data, size_t size);
+
+bool saveSnapshot(const GameState &state, const char *path);
+bool loadSnapshot(GameState &state, const char *path, const GameRules &rules = defaultRules);
+
+#endif
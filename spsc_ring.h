@@ -0,0 +1,42 @@
+// spsc_ring.h - 단일 생산자/단일 소비자 락프리 링 버퍼
+// 생산자 스레드만 tail 을, 소비자 스레드만 head 를 쓴다. 두 인덱스는 계속 증가하고
+// 슬롯 위치는 마스크로 구하므로 용량은 2의 거듭제곱이어야 한다.
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+
+template <typename T, unsigned Capacity> struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    // Producer side. Returns false (and drops the item) when the ring is full.
+    bool push(const T &item) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        slots[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(T &item) {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        item = slots[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Discards everything currently queued.
+    void drain() { head.store(tail.load(std::memory_order_acquire), std::memory_order_release); }
+
+  private:
+    T slots[Capacity];
+    alignas(64) std::atomic<unsigned> head{0}; // Next slot to pop
+    alignas(64) std::atomic<unsigned> tail{0}; // Next slot to push
+};
+
+#endif
@@ -0,0 +1,91 @@
+// tick_scheduler.h - 고정 간격 틱 스케줄러
+// CLOCK_MONOTONIC 기준의 절대 마감 시각(deadline)을 주기만큼 더해 가므로
+// 입력이나 렌더링에 걸린 시간과 상관없이 틱 간격이 밀리지 않는다.
+// 매 틱이 마감 시각보다 얼마나 늦게 시작했는지(jitter)를 통계로 남긴다.
+
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <time.h>
+
+inline long long monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+struct TickJitterStats {
+    long long ticks     = 0;
+    long long totalNs   = 0;
+    long long maxNs     = 0;
+    long long lateTicks = 0; // Started 1 ms or more after their deadline
+    long long resyncs   = 0; // Fell a whole period behind and skipped ahead
+
+    void record(long long jitterNs) {
+        ticks++;
+        totalNs += jitterNs;
+        if (jitterNs > maxNs)
+            maxNs = jitterNs;
+        if (jitterNs >= 1000000)
+            lateTicks++;
+    }
+
+    void merge(const TickJitterStats &other) {
+        ticks += other.ticks;
+        totalNs += other.totalNs;
+        lateTicks += other.lateTicks;
+        resyncs += other.resyncs;
+        if (other.maxNs > maxNs)
+            maxNs = other.maxNs;
+    }
+
+    double meanUs() const { return ticks ? totalNs / 1000.0 / ticks : 0.0; }
+    double maxUs() const { return maxNs / 1000.0; }
+};
+
+struct TickScheduler {
+    long long       periodNs   = 0;
+    long long       deadlineNs = 0; // When the next tick is due
+    TickJitterStats stats;
+
+    // First tick is due one period from now.
+    void start(long long periodUs) {
+        periodNs = periodUs * 1000;
+        resync();
+    }
+
+    // Changes the pace and restarts the clock, e.g. after a stage transition.
+    void setPeriod(long long periodUs) { start(periodUs); }
+
+    // Restarts the clock from now, e.g. after a pause.
+    void resync() { deadlineNs = monotonicNs() + periodNs; }
+
+    bool due() const { return monotonicNs() >= deadlineNs; }
+
+    // Sleeps until the next tick is due, but at most `maxWaitNs` so the caller can
+    // keep servicing input while it waits.
+    void waitUntilDue(long long maxWaitNs) const {
+        long long wakeNs = monotonicNs() + maxWaitNs;
+        if (wakeNs > deadlineNs)
+            wakeNs = deadlineNs;
+        timespec ts;
+        ts.tv_sec  = wakeNs / 1000000000LL;
+        ts.tv_nsec = wakeNs % 1000000000LL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) != 0) {
+        }
+    }
+
+    // Call when a tick starts. Records its jitter and schedules the next one a fixed
+    // period after this deadline, so lateness never accumulates into drift.
+    void beginTick() {
+        long long now = monotonicNs();
+        stats.record(now - deadlineNs);
+        deadlineNs += periodNs;
+        if (deadlineNs <= now) { // Suspended or stalled: don't replay the missed ticks
+            deadlineNs = now + periodNs;
+            stats.resyncs++;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,179 @@
+// timing_wheel.h - 계층형 타이밍 휠 (per-entity 타이머)
+// 4단계 x 64칸 구조로 2^24 틱까지 예약할 수 있다. 예약/취소는 O(1),
+// advance()는 틱마다 해당 칸의 타이머만 처리하고 64틱마다 상위 단계를 한 칸씩 내려보낸다.
+// 노드는 고정 크기 풀에서 꺼내 쓰므로 GameState 안에 값으로 들어가도 할당이 없다.
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+template <int MaxTimers> struct TimingWheel {
+    static const int LEVELS     = 4;
+    static const int SLOT_BITS  = 6;
+    static const int SLOTS      = 1 << SLOT_BITS;
+    static const int SLOT_MASK  = SLOTS - 1;
+    static const int WORK_LIST  = LEVELS * SLOTS; // Timers firing in the current advance()
+    static const int FREE_LIST  = WORK_LIST + 1;
+    static const int LIST_COUNT = FREE_LIST + 1;
+
+    struct Node {
+        int       next, prev;
+        int       list; // Which list the node is linked into
+        long long expires;
+        int       kind;
+        int       payload;
+    };
+
+    Node      nodes[MaxTimers];
+    int       heads[LIST_COUNT];
+    long long base = 0; // Next tick to be processed by advance()
+
+    TimingWheel() { clear(); }
+
+    // Drops every timer and rewinds the clock.
+    void clear() {
+        base = 0;
+        for (int i = 0; i < LIST_COUNT; ++i)
+            heads[i] = -1;
+        for (int i = MaxTimers - 1; i >= 0; --i) {
+            nodes[i].list = -1;
+            link(i, FREE_LIST);
+        }
+    }
+
+    // Fires during the `delay`-th advance() from now (delay >= 1).
+    // Returns the timer id, or -1 when the pool is exhausted.
+    int schedule(long long delay, int kind, int payload) {
+        int id = heads[FREE_LIST];
+        if (id < 0)
+            return -1;
+        unlink(id);
+        nodes[id].expires = base + (delay > 0 ? delay : 1) - 1;
+        nodes[id].kind    = kind;
+        nodes[id].payload = payload;
+        place(id);
+        return id;
+    }
+
+    void cancel(int id) {
+        if (id < 0 || nodes[id].list == FREE_LIST)
+            return;
+        unlink(id);
+        link(id, FREE_LIST);
+    }
+
+    bool active(int id) const { return id >= 0 && nodes[id].list != FREE_LIST; }
+
+    // advance() calls left until the timer fires (1 = next tick).
+    long long remaining(int id) const { return nodes[id].expires - base + 1; }
+
+    // Moves timer `id` to the end of `list` as it is. Only for rebuilding a saved wheel list by
+    // list, fields and base filled in first (snapshot.cpp); use schedule() and cancel() otherwise.
+    void append(int id, int list) {
+        unlink(id);
+        nodes[id].list = list;
+        nodes[id].next = -1;
+        nodes[id].prev = -1;
+        int tail       = heads[list];
+        if (tail < 0) {
+            heads[list] = id;
+            return;
+        }
+        while (nodes[tail].next >= 0)
+            tail = nodes[tail].next;
+        nodes[tail].next = id;
+        nodes[id].prev   = tail;
+    }
+
+    // Whether place() and the cascades can have left a timer expiring at `expires` in wheel
+    // list `list` (level * SLOTS + slot) by now.
+    bool fits(int list, long long expires) const {
+        int       level = list / SLOTS;
+        long long delta = expires - base;
+        if (list < 0 || list >= WORK_LIST || delta < 0)
+            return false;
+        if (level < LEVELS - 1 && delta >= (1LL << ((level + 1) * SLOT_BITS)))
+            return false;
+        // An upper level holds a timer due in the current block only until that block cascades
+        int shift = level * SLOT_BITS;
+        if (level > 0 && (expires >> shift) == (base >> shift) && (base & ((1LL << shift) - 1)))
+            return false;
+        return (int)((expires >> shift) & SLOT_MASK) == list % SLOTS;
+    }
+
+    // Processes one tick, calling onExpire(id, kind, payload) for each due timer.
+    // The timer is already released when the callback runs, so it may schedule new ones.
+    template <typename Fn> void advance(Fn onExpire) {
+        int index = (int)(base & SLOT_MASK);
+        if (index == 0) {
+            for (int level = 1; level < LEVELS; ++level) {
+                int slot = (int)((base >> (level * SLOT_BITS)) & SLOT_MASK);
+                cascade(level, slot);
+                if (slot != 0)
+                    break;
+            }
+        }
+        ++base;
+
+        // Move the due slot to the work list so timers placed by callbacks can't join it
+        heads[WORK_LIST] = heads[index];
+        heads[index]     = -1;
+        for (int id = heads[WORK_LIST]; id >= 0; id = nodes[id].next)
+            nodes[id].list = WORK_LIST;
+
+        while (heads[WORK_LIST] >= 0) {
+            int   id   = heads[WORK_LIST];
+            Node &node = nodes[id];
+            unlink(id);
+            link(id, FREE_LIST);
+            onExpire(id, node.kind, node.payload);
+        }
+    }
+
+  private:
+    void link(int id, int list) {
+        nodes[id].list = list;
+        nodes[id].prev = -1;
+        nodes[id].next = heads[list];
+        if (heads[list] >= 0)
+            nodes[heads[list]].prev = id;
+        heads[list] = id;
+    }
+
+    void unlink(int id) {
+        Node &node = nodes[id];
+        if (node.prev >= 0)
+            nodes[node.prev].next = node.next;
+        else
+            heads[node.list] = node.next;
+        if (node.next >= 0)
+            nodes[node.next].prev = node.prev;
+        node.list = -1;
+    }
+
+    // Chooses the level by distance to expiry, the slot by the expiry tick itself.
+    void place(int id) {
+        long long expires = nodes[id].expires;
+        long long delta   = expires - base;
+        if (delta < 0)
+            expires = base; // Overdue timers fire on the next tick
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1LL << ((level + 1) * SLOT_BITS)))
+            ++level;
+        int slot = (int)((expires >> (level * SLOT_BITS)) & SLOT_MASK);
+        link(id, level * SLOTS + slot);
+    }
+
+    // Re-places every timer of one upper-level slot; they land on lower levels.
+    void cascade(int level, int slot) {
+        int list    = level * SLOTS + slot;
+        int id      = heads[list];
+        heads[list] = -1;
+        while (id >= 0) {
+            int next = nodes[id].next;
+            place(id);
+            id = next;
+        }
+    }
+};
+
+#endif
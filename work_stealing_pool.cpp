@@ -0,0 +1,91 @@
+// work_stealing_pool.cpp - 작업 훔치기 스레드 풀 구현
+
+#include "work_stealing_pool.h"
+
+// Which pool and worker the current thread is, so submits from a task stay local
+static thread_local WorkStealingPool *currentPool   = nullptr;
+static thread_local int               currentWorker = -1;
+
+void WorkStealingPool::start(int count) {
+    stop();
+    if (count < 1)
+        count = 1;
+    workers.clear();
+    for (int i = 0; i < count; ++i)
+        workers.push_back(std::make_unique<Worker>());
+    running.store(true, std::memory_order_release);
+    for (int i = 0; i < count; ++i)
+        threads.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+void WorkStealingPool::stop() {
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        running.store(false, std::memory_order_release);
+    }
+    idle.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+void WorkStealingPool::submit(PoolTask task) {
+    int index = currentPool == this ? currentWorker
+                                    : (int)(nextWorker.fetch_add(1) % workers.size());
+    {
+        std::lock_guard<std::mutex> guard(workers[index]->lock);
+        workers[index]->tasks.push_back(task);
+        pending.fetch_add(1, std::memory_order_release);
+    }
+    // Taking the lock orders this against a worker that just found nothing to do
+    { std::lock_guard<std::mutex> guard(idleLock); }
+    idle.notify_one();
+}
+
+bool WorkStealingPool::take(int index, PoolTask &task) {
+    {
+        Worker                     &own = *workers[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    int count = (int)workers.size();
+    for (int i = 1; i < count; ++i) {
+        Worker                     &victim = *workers[(index + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int index) {
+    currentPool   = this;
+    currentWorker = index;
+    PoolTask task;
+    for (;;) {
+        if (take(index, task)) {
+            task.run(task.arg);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(idleLock);
+        if (!running.load(std::memory_order_acquire) &&
+            pending.load(std::memory_order_acquire) == 0)
+            break;
+        idle.wait(guard, [this] {
+            return pending.load(std::memory_order_acquire) > 0 ||
+                   !running.load(std::memory_order_acquire);
+        });
+    }
+    currentPool   = nullptr;
+    currentWorker = -1;
+}
@@ -0,0 +1,56 @@
+// work_stealing_pool.h - 작업 훔치기(work stealing) 스레드 풀
+// 작업자마다 자기 덱이 있다. 자기 덱은 뒤에서 꺼내고(LIFO), 비어 있으면 다른 작업자의 덱
+// 앞에서 훔쳐 온다(FIFO). 바깥 스레드가 넣는 작업은 작업자들에게 돌아가며 나눠 주고,
+// 작업자가 넣는 작업은 자기 덱에 들어간다.
+// 작업은 함수 포인터 + 인자라서 넣을 때 할당이 없다 (덱이 자랄 때만 빼고).
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct PoolTask {
+    void (*run)(void *arg);
+    void *arg;
+};
+
+struct WorkStealingPool {
+    ~WorkStealingPool() { stop(); }
+
+    // Starts `threads` workers (at least one).
+    void start(int threads);
+    // Runs what is still queued, then joins the workers.
+    void stop();
+
+    // Any thread. Tasks run in no particular order.
+    void submit(PoolTask task);
+
+    int       size() const { return (int)threads.size(); }
+    long long steals() const { return stolen.load(std::memory_order_relaxed); }
+
+  private:
+    struct alignas(64) Worker {
+        std::mutex           lock;
+        std::deque<PoolTask> tasks;
+    };
+
+    void run(int index);
+    bool take(int index, PoolTask &task); // Own deque first, then the others
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread>             threads;
+    std::mutex                           idleLock;
+    std::condition_variable              idle;
+    std::atomic<int>                     pending{0}; // Tasks sitting in some deque
+    std::atomic<bool>                    running{false};
+    std::atomic<unsigned>                nextWorker{0}; // Round robin for outside submits
+    std::atomic<long long>               stolen{0};
+};
+
+#endif